@@ -0,0 +1,226 @@
+/*
+ * bmath microbenchmarks, run from `meson bench`. Each case reports the
+ * median time per operation over several repetitions, so SIMD and algorithm
+ * changes can be compared build against build (e.g. -Db_ndebug, -mavx2,
+ * -DBEG_NO_SIMD).
+ */
+
+#include <bmath.h>
+#include <affine.h>
+#include <batch.h>
+#include <fastmath.h>
+#include <geometry.h>
+#include <jobs.h>
+#include <trs.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace BEG;
+
+namespace {
+
+/* keeps the optimiser from discarding results it can see are unused */
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+std::mt19937 sRandom{ 7 };
+
+float uniform(float min, float max) {
+    return std::uniform_real_distribution<float>{ min, max }(sRandom);
+}
+
+constexpr size_t Inputs{ 1024 };
+constexpr int Repetitions{ 9 };
+
+/* `body(i)` is one operation on input i; reports ns per operation */
+template <typename Body>
+void bench(const char* name, size_t operations, Body body) {
+    std::vector<double> samples{};
+
+    for (int rep{ 0 }; rep < Repetitions; ++rep) {
+        auto start{ std::chrono::steady_clock::now() };
+        for (size_t i{ 0 }; i < operations; ++i) {
+            body(i % Inputs);
+        }
+        auto end{ std::chrono::steady_clock::now() };
+
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(operations));
+    }
+
+    std::sort(samples.begin(), samples.end());
+    std::printf("%-40s %10.2f ns/op\n", name, samples[samples.size() / 2]);
+}
+
+/* whole-array kernels, reports ns per element */
+template <typename Body>
+void benchArray(const char* name, size_t elements, int calls, Body body) {
+    std::vector<double> samples{};
+
+    for (int rep{ 0 }; rep < Repetitions; ++rep) {
+        auto start{ std::chrono::steady_clock::now() };
+        for (int call{ 0 }; call < calls; ++call) {
+            body();
+        }
+        auto end{ std::chrono::steady_clock::now() };
+
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(elements * static_cast<size_t>(calls)));
+    }
+
+    std::sort(samples.begin(), samples.end());
+    std::printf("%-40s %10.3f ns/element\n", name, samples[samples.size() / 2]);
+}
+
+}
+
+int main() {
+    std::printf("bmath benchmarks, SIMD %s, %zu pool workers\n\n", SIMD::Enabled ? "on" : "off", JobPool::shared().threads());
+
+    std::vector<Vector<3>> v3(Inputs), w3(Inputs);
+    std::vector<Vector<4>> v4(Inputs), w4(Inputs);
+    std::vector<Matrix<4>> m4(Inputs), rigid(Inputs);
+    std::vector<Quaternion> q(Inputs), r(Inputs);
+    std::vector<TRS> trs(Inputs);
+    std::vector<float> angles(Inputs);
+
+    for (size_t i{ 0 }; i < Inputs; ++i) {
+        v3[i] = { uniform(-10.0f, 10.0f), uniform(-10.0f, 10.0f), uniform(-10.0f, 10.0f) };
+        w3[i] = { uniform(-10.0f, 10.0f), uniform(-10.0f, 10.0f), uniform(-10.0f, 10.0f) };
+        v4[i] = { v3[i], 1.0f };
+        w4[i] = { w3[i], 1.0f };
+        q[i] = Quaternion{ uniform(-Pi, Pi), uniform(-Pi, Pi), uniform(-Pi, Pi) };
+        r[i] = Quaternion{ uniform(-Pi, Pi), uniform(-Pi, Pi), uniform(-Pi, Pi) };
+        trs[i] = { v3[i], q[i], { uniform(0.5f, 2.0f), uniform(0.5f, 2.0f), uniform(0.5f, 2.0f) } };
+        m4[i] = trs[i].toMatrix();
+        rigid[i] = Affine::tr(v3[i], q[i]);
+        angles[i] = uniform(-10.0f, 10.0f);
+    }
+
+    constexpr size_t Operations{ 1 << 20 };
+
+    std::printf("vectors\n");
+    bench("Vector<3>::dot", Operations, [&](size_t i) { keep(v3[i].dot(w3[i])); });
+    bench("Vector<4>::dot", Operations, [&](size_t i) { keep(v4[i].dot(w4[i])); });
+    bench("Vector<3>::cross", Operations, [&](size_t i) { keep(v3[i].cross(w3[i])); });
+    bench("Vector<3>::normalized", Operations, [&](size_t i) { keep(v3[i].normalized()); });
+    bench("Fast::normalized(Vector<3>)", Operations, [&](size_t i) { keep(Fast::normalized(v3[i])); });
+    bench("Vector<4>::addScaled", Operations, [&](size_t i) { Vector<4> a{ v4[i] }; keep(a.addScaled(w4[i], 0.5f)); });
+    bench("Vector<4> += Vector<4> * s", Operations, [&](size_t i) { Vector<4> a{ v4[i] }; keep(a += w4[i] * 0.5f); });
+
+    std::printf("\nmatrices\n");
+    bench("Matrix<4> * Matrix<4>", Operations, [&](size_t i) { keep(m4[i] * m4[(i + 1) % Inputs]); });
+    bench("Matrix<4> * Vector<4>", Operations, [&](size_t i) { keep(m4[i] * v4[i]); });
+    bench("Matrix<4>::transpose", Operations, [&](size_t i) { keep(m4[i].transpose()); });
+    bench("Matrix<4>::inverse", Operations, [&](size_t i) { keep(m4[i].inverse()); });
+    bench("Matrix<4>::inverseAffine", Operations, [&](size_t i) { keep(m4[i].inverseAffine()); });
+    bench("Matrix<4>::inverseRigid", Operations, [&](size_t i) { keep(rigid[i].inverseRigid()); });
+    bench("Matrix<4>::adjointInverse", Operations / 16, [&](size_t i) { keep(m4[i].adjointInverse()); });
+    bench("Matrix<4>::determinant", Operations, [&](size_t i) { keep(m4[i].determinant()); });
+
+    std::printf("\nquaternions and transforms\n");
+    bench("Quaternion * Quaternion", Operations, [&](size_t i) { keep(q[i] * r[i]); });
+    bench("Quaternion::rotate", Operations, [&](size_t i) { keep(q[i].rotate(v3[i])); });
+    bench("Quaternion::toMatrix * Vector<4>", Operations, [&](size_t i) { keep(q[i].toMatrix() * v4[i]); });
+    bench("Quaternion::slerp", Operations, [&](size_t i) { keep(q[i].slerp(r[i], 0.3f)); });
+    bench("Quaternion::nlerp", Operations, [&](size_t i) { keep(q[i].nlerp(r[i], 0.3f)); });
+    bench("Quaternion(x, y, z)", Operations, [&](size_t i) { keep(Quaternion{ angles[i], angles[(i + 1) % Inputs], angles[(i + 2) % Inputs] }); });
+    bench("Fast::fromEuler", Operations, [&](size_t i) { keep(Fast::fromEuler(angles[i], angles[(i + 1) % Inputs], angles[(i + 2) % Inputs])); });
+    bench("Affine::trs", Operations, [&](size_t i) { keep(Affine::trs(trs[i].translation, trs[i].rotation, trs[i].scale)); });
+    bench("translation * rotation * scale", Operations, [&](size_t i) {
+        keep(Affine::translation(trs[i].translation) * trs[i].rotation.toMatrix() * Affine::scale(trs[i].scale));
+    });
+    bench("TRS * TRS", Operations, [&](size_t i) { keep(trs[i] * trs[(i + 1) % Inputs]); });
+    bench("TRS::inverse", Operations, [&](size_t i) { keep(trs[i].inverse()); });
+
+    std::printf("\nfast math\n");
+    bench("sinf + cosf", Operations, [&](size_t i) { keep(sinf(angles[i]) + cosf(angles[i])); });
+    bench("Fast::sincos", Operations, [&](size_t i) { float s, c; Fast::sincos(angles[i], s, c); keep(s + c); });
+    bench("Fast::sincos4 (4 angles)", Operations / 4, [&](size_t i) {
+        SIMD::Float4 s, c;
+        Fast::sincos4(SIMD::load(&angles[i & ~size_t{ 3 }]), s, c);
+        keep(s);
+        keep(c);
+    });
+    bench("atan2f", Operations, [&](size_t i) { keep(atan2f(v3[i].x(), v3[i].y())); });
+    bench("Fast::atan2", Operations, [&](size_t i) { keep(Fast::atan2(v3[i].x(), v3[i].y())); });
+    bench("1 / sqrtf", Operations, [&](size_t i) { keep(1.0f / sqrtf(angles[i] * angles[i] + 1.0f)); });
+    bench("Fast::rsqrt", Operations, [&](size_t i) { keep(Fast::rsqrt(angles[i] * angles[i] + 1.0f)); });
+
+    std::printf("\nbatch kernels\n");
+    for (size_t elements : { size_t{ 1024 }, size_t{ 1 } << 20 }) {
+        std::vector<Vector<3>> in(elements), out(elements);
+        std::vector<float> x(elements), y(elements), z(elements), ox(elements), oy(elements), oz(elements);
+        for (size_t i{ 0 }; i < elements; ++i) {
+            in[i] = v3[i % Inputs];
+            x[i] = in[i].x();
+            y[i] = in[i].y();
+            z[i] = in[i].z();
+        }
+
+        int calls{ elements > 4096 ? 4 : 1024 };
+        const Matrix<4>& m{ m4[0] };
+        char label[64];
+
+        std::snprintf(label, sizeof(label), "loop of Matrix * Vector<4>, %zu", elements);
+        benchArray(label, elements, calls, [&] {
+            for (size_t i{ 0 }; i < elements; ++i) {
+                out[i] = Vector<3>(m * Vector<4>(in[i], 1.0f));
+            }
+            keep(out.data());
+        });
+
+        std::snprintf(label, sizeof(label), "Batch::transformPoints AoS, %zu", elements);
+        benchArray(label, elements, calls, [&] { Batch::transformPoints(m, in, out); keep(out.data()); });
+
+        std::snprintf(label, sizeof(label), "Batch::transformPoints SoA, %zu", elements);
+        benchArray(label, elements, calls, [&] { Batch::transformPoints(m, { x, y, z }, Batch::SoA3{ ox, oy, oz }); keep(ox.data()); });
+
+        std::snprintf(label, sizeof(label), "Batch::transformNormals AoS, %zu", elements);
+        benchArray(label, elements, calls, [&] { Batch::transformNormals(m, in, out); keep(out.data()); });
+    }
+
+    std::printf("\nculling\n");
+    {
+        constexpr size_t Elements{ 1 << 16 };
+        constexpr int Calls{ 64 };
+
+        std::vector<float> cx(Elements), cy(Elements), cz(Elements), ex(Elements), ey(Elements), ez(Elements);
+        std::vector<AABB> boxes(Elements);
+        std::vector<std::uint64_t> mask(maskWords(Elements));
+        for (size_t i{ 0 }; i < Elements; ++i) {
+            cx[i] = uniform(-60.0f, 60.0f);
+            cy[i] = uniform(-60.0f, 60.0f);
+            cz[i] = uniform(-120.0f, 10.0f);
+            ex[i] = ey[i] = ez[i] = uniform(0.0f, 5.0f);
+            boxes[i] = AABB::fromCenterExtents({ cx[i], cy[i], cz[i] }, { ex[i], ey[i], ez[i] });
+        }
+
+        Frustum frustum{ Frustum::fromMatrix(m4[0]) };
+        Ray ray{ v3[0], w3[0] };
+
+        benchArray("loop of Frustum::intersects(AABB)", Elements, Calls, [&] {
+            for (size_t i{ 0 }; i < Elements; ++i) {
+                if (frustum.intersects(boxes[i]))
+                    mask[i / 64] |= std::uint64_t{ 1 } << (i % 64);
+            }
+            keep(mask.data());
+        });
+        benchArray("Frustum::test(AABBSoA)", Elements, Calls, [&] { frustum.test(AABBSoA{ cx, cy, cz, ex, ey, ez }, mask); keep(mask.data()); });
+        benchArray("Frustum::test(SphereSoA)", Elements, Calls, [&] { frustum.test(SphereSoA{ cx, cy, cz, ex }, mask); keep(mask.data()); });
+        benchArray("loop of Ray::intersect(AABB)", Elements, Calls, [&] {
+            for (size_t i{ 0 }; i < Elements; ++i) {
+                if (ray.intersect(boxes[i]))
+                    mask[i / 64] |= std::uint64_t{ 1 } << (i % 64);
+            }
+            keep(mask.data());
+        });
+        benchArray("Ray::test(AABBSoA)", Elements, Calls, [&] { ray.test(AABBSoA{ cx, cy, cz, ex, ey, ez }, mask); keep(mask.data()); });
+    }
+
+    return 0;
+}
@@ -6,17 +6,54 @@
 namespace BEG {
 
 namespace Affine {
-    Matrix<4> translation(Number x, Number y, Number z);
-    Matrix<4> translation(Number t);
-    Matrix<4> translation(const Vector<3>& t);
+    constexpr Matrix<4> translation(Number x, Number y, Number z) {
+        return {
+            1.0f, 0.0f, 0.0f, x,
+            0.0f, 1.0f, 0.0f, y,
+            0.0f, 0.0f, 1.0f, z,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+    }
 
-    Matrix<4> scale(Number x, Number y, Number z);
-    Matrix<4> scale(Number s);
-    Matrix<4> scale(const Vector<3>& s);
+    constexpr Matrix<4> translation(Number t) { return translation(t, t, t); }
+    constexpr Matrix<4> translation(const Vector<3>& t) { return translation(t.x(), t.y(), t.z()); }
+
+    constexpr Matrix<4> scale(Number x, Number y, Number z) {
+        return {
+            x,    0.0f, 0.0f, 0.0f,
+            0.0f, y,    0.0f, 0.0f,
+            0.0f, 0.0f, z,    0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+    }
+
+    constexpr Matrix<4> scale(Number s) { return scale(s, s, s); }
+    constexpr Matrix<4> scale(const Vector<3>& s) { return scale(s.x(), s.y(), s.z()); }
 
     Matrix<4> rotation(Number theta, const Vector<3>& axis);
+
+    /* translation(t) * r.toMatrix() * scale(s) written out directly, the rotation columns just pick up the scale */
+    constexpr Matrix<4> trs(const Vector<3>& t, const Quaternion& r, const Vector<3>& s) {
+        Number x{ r.x() }, y{ r.y() }, z{ r.z() }, w{ r.w() };
+        Number x2{ x * x }, y2{ y * y }, z2{ z * z };
+        return {
+            (1.0f - (2.0f * y2) - (2.0f * z2)) * s.x(), ((2.0f * x * y) - (2.0f * w * z)) * s.y(), ((2.0f * x * z) + (2.0f * w * y)) * s.z(), t.x(),
+            ((2.0f * x * y) + (2.0f * w * z)) * s.x(), (1.0f - (2.0f * x2) - (2.0f * z2)) * s.y(), ((2.0f * y * z) - (2.0f * w * x)) * s.z(), t.y(),
+            ((2.0f * x * z) - (2.0f * w * y)) * s.x(), ((2.0f * y * z) + (2.0f * w * x)) * s.y(), (1.0f - (2.0f * x2) - (2.0f * y2)) * s.z(), t.z(),
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+    }
+
+    /* translation(t) * r.toMatrix() without the product */
+    constexpr Matrix<4> tr(const Vector<3>& t, const Quaternion& r) {
+        Matrix<4> result{ r.toMatrix() };
+        result.at(0, 3) = t.x();
+        result.at(1, 3) = t.y();
+        result.at(2, 3) = t.z();
+        return result;
+    }
 }
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -7,16 +7,19 @@
 
 #include <bmath.h>
 #include <affine.h>
+#include <trs.h>
 #include <ecs.h>
 
 namespace BEG {
 
 struct Transform : Component {
-    Vector<3> position{ 0.0f, 0.0f, 0.0f };
+    Position position{ 0.0f, 0.0f, 0.0f };
     Quaternion orientation{ 1.0f, 0.0f, 0.0f, 0.0f };
     Vector<3> scale{ 1.0f, 1.0f, 1.0f };
 
-    Matrix<4> toMatrix() const;
+    /* relative to `origin`, which is subtracted at full position precision before narrowing */
+    TRS trs(const Position& origin = {}) const;
+    Matrix<4> toMatrix(const Position& origin = {}) const;
 };
 
 }
@@ -0,0 +1,49 @@
+#ifndef BEG_BATCH_H
+#define BEG_BATCH_H
+
+#include <bmath.h>
+
+#include <span>
+
+namespace BEG {
+
+/*
+ * Transform whole arrays by one matrix. Points take the translation,
+ * directions ignore it and normals go through the inverse transpose of the
+ * 3x3 block and come out unit length. Each element matches what
+ * `matrix * Vector<4>(v, w)` gives, bit for bit.
+ *
+ * The arithmetic runs 8 wide on AVX, 4 wide on SSE/NEON, and large arrays
+ * are split across JobPool::shared(). `out` may be the same array as `in`.
+ */
+namespace Batch {
+    enum class BatchError {
+        SizeMismatchError
+    };
+
+    /* below this many elements a single thread is faster than waking the pool */
+    inline constexpr size_t ParallelThreshold{ 16384 };
+
+    /* separate x, y and z arrays of equal length */
+    struct ConstSoA3 {
+        std::span<const float> x{}, y{}, z{};
+    };
+
+    struct SoA3 {
+        std::span<float> x{}, y{}, z{};
+
+        operator ConstSoA3() const { return { x, y, z }; }
+    };
+
+    void transformPoints(const Matrix<4>& matrix, std::span<const Vector<3>> in, std::span<Vector<3>> out);
+    void transformDirections(const Matrix<4>& matrix, std::span<const Vector<3>> in, std::span<Vector<3>> out);
+    void transformNormals(const Matrix<4>& matrix, std::span<const Vector<3>> in, std::span<Vector<3>> out);
+
+    void transformPoints(const Matrix<4>& matrix, ConstSoA3 in, SoA3 out);
+    void transformDirections(const Matrix<4>& matrix, ConstSoA3 in, SoA3 out);
+    void transformNormals(const Matrix<4>& matrix, ConstSoA3 in, SoA3 out);
+}
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <bmath.h>
 #include <affine.h>
+#include <fastmath.h>
 #include <shader.h>
 #include <camera.h>
 #include <model.h>
@@ -6,26 +6,65 @@
 #include <cmath>
 #include <iterator>
 #include <iostream>
+#include <limits>
 #include <tuple>
+#include <type_traits>
+
+#include <simd.h>
 
 namespace BEG {
 
 using Number = float;
 
-const float Pi = M_PIf32;
+/*
+ * Scalar of world positions. Building with BEG_DOUBLE_POSITIONS (meson
+ * -Ddouble_positions=true) makes it double, for worlds where float runs out
+ * of precision a few km from the origin. Only positions widen, everything
+ * that reaches the GPU stays Number after Camera::relative takes the camera
+ * origin out.
+ */
+#if defined(BEG_DOUBLE_POSITIONS)
+using PositionNumber = double;
+#else
+using PositionNumber = Number;
+#endif
+
+inline constexpr Number Pi{ M_PIf32 };
+
+constexpr Number toRadians(Number degrees) {
+    return Pi * (degrees / 180.0f);
+}
 
-Number toRadians(Number degrees);
-Number toDegrees(Number radians);
+constexpr Number toDegrees(Number radians) {
+    return 180.0f * (radians / Pi);
+}
 
-Number clamp(Number value, Number min, Number max);
+template <typename T>
+constexpr T clamp(T value, T min, T max) {
+    if (value > max)
+        return max;
+    else if (value < min)
+        return min;
+    else
+        return value;
+}
 
-template <size_t N>
+template <size_t N, typename T = Number>
 class Vector {
 protected:
-    std::array<Number, N> mValues{};
+    std::array<T, N> mValues{};
+
+    /* a float Vector<4> maps onto one SIMD register when the target has them, see simd.h */
+    static constexpr bool Wide{ N == 4 && SIMD::Enabled && std::is_same_v<T, float> };
 public:
-    static Number dot(const Vector& a, const Vector& b) {
-        Number sum{ 0 };
+    static constexpr T dot(const Vector& a, const Vector& b) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                return SIMD::dot4(a.mValues.data(), b.mValues.data());
+            }
+        }
+
+        T sum{ 0 };
 
         for (size_t i{ 0 }; i < N; ++i) {
             sum += a.mValues[i] * b.mValues[i];
@@ -34,7 +73,7 @@ public:
         return sum;
     }
 
-    static Vector cross(const Vector& a, const Vector& b) {
+    static constexpr Vector cross(const Vector& a, const Vector& b) {
         static_assert(N == 3, "cross products between 2 vectors only exist in the 3rd dimension");
         return {
             (a.y() * b.z()) - (a.z() * b.y()),
@@ -43,72 +82,79 @@ public:
         };
     }
 
-    Vector(Number value = 0.0f) : mValues{} {
+    constexpr Vector(T value = 0.0f) : mValues{} {
         static_assert(N > 0, "cannot have zero length vector");
         mValues.fill(value);
     }
 
-    template<typename... T>
-    Vector(T... values) : mValues{ values... } {
+    /* constrained so a single scalar of another type still picks the fill constructor above */
+    template<typename... Values> requires (sizeof...(Values) == N && N > 1)
+    constexpr Vector(Values... values) : mValues{ values... } {
         static_assert(N > 0, "cannot have zero length vector");
-        static_assert(sizeof...(values) == N, "invalid number of parameters");
     }
 
-    Vector(const Vector& other) : mValues{ other.mValues } {}
-    Vector& operator=(const Vector& other) {
+    constexpr Vector(const Vector& other) : mValues{ other.mValues } {}
+    constexpr Vector& operator=(const Vector& other) {
         std::copy(other.mValues.begin(), other.mValues.end(), mValues.begin());
         
         return *this;
     }
 
-    /* shrinking conversion */
-    template<size_t M>
-    Vector(const Vector<M>& other) : mValues{} {
+    /* shrinking and scalar conversion, implicit unless it would lose precision */
+    template<size_t M, typename U>
+    constexpr explicit(std::numeric_limits<U>::digits > std::numeric_limits<T>::digits) Vector(const Vector<M, U>& other) : mValues{} {
         static_assert(M >= N, "cannot perform a shrinking vector conversion on a smaller vector");
         for (size_t i{ 0 }; i < N; ++i) {
-            mValues[i] = other[i];
+            mValues[i] = static_cast<T>(other[i]);
         }
     }
 
     /* growing conversion */
-    template<typename... T, size_t M>
-    Vector(const Vector<M>& other, T... values) : mValues{} {
+    template<typename... Values, size_t M> requires (sizeof...(Values) > 0)
+    constexpr Vector(const Vector<M, T>& other, Values... values) : mValues{} {
         static_assert(M + sizeof...(values) == N, "invalid number of parameters");
-        for (size_t i{ 0 }; i < N; ++i) {
+        for (size_t i{ 0 }; i < M; ++i) {
             mValues[i] = other[i];
         }
 
-        std::array<Number, sizeof...(values)> arr{ values... };
+        std::array<T, sizeof...(values)> arr{ values... };
         std::copy(arr.begin(), arr.end(), mValues.begin() + M);
     }
 
-    size_t size() const {
+    constexpr size_t size() const {
         return N;
     }
 
-    const std::array<Number, N>& data() const {
+    constexpr const std::array<T, N>& data() const {
         return mValues;
     }
 
-    std::array<Number, N>& data() {
+    constexpr std::array<T, N>& data() {
         return mValues;
     }
 
-    Number x() const { static_assert(N >= 1, "vector has no member x"); return mValues[0]; }
-    void x(Number n) { static_assert(N >= 2, "vector has no member x"); mValues[0] = n; }  
+    constexpr T x() const { static_assert(N >= 1, "vector has no member x"); return mValues[0]; }
+    constexpr void x(T n) { static_assert(N >= 2, "vector has no member x"); mValues[0] = n; }  
 
-    Number y() const { static_assert(N >= 2, "vector has no member y"); return mValues[1]; }
-    void y(Number n) { static_assert(N >= 2, "vector has no member y"); mValues[1] = n; }
+    constexpr T y() const { static_assert(N >= 2, "vector has no member y"); return mValues[1]; }
+    constexpr void y(T n) { static_assert(N >= 2, "vector has no member y"); mValues[1] = n; }
 
-    Number z() const { static_assert(N >= 3, "vector has no member z"); return mValues[2]; }
-    void z(Number n) { static_assert(N >= 3, "vector has no member z"); mValues[2] = n; }
+    constexpr T z() const { static_assert(N >= 3, "vector has no member z"); return mValues[2]; }
+    constexpr void z(T n) { static_assert(N >= 3, "vector has no member z"); mValues[2] = n; }
 
-    Number w() const { static_assert(N >= 4, "vector has no member z"); return mValues[3]; }
-    void w(Number n) { static_assert(N >= 4, "vector has no member z"); mValues[3] = n; }
+    constexpr T w() const { static_assert(N >= 4, "vector has no member z"); return mValues[3]; }
+    constexpr void w(T n) { static_assert(N >= 4, "vector has no member z"); mValues[3] = n; }
 
-    Vector operator+(const Vector& other) const {
+    constexpr Vector operator+(const Vector& other) const {
         Vector result{};
 
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(result.mValues.data(), SIMD::add(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return result;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             result.mValues[i] = mValues[i] + other.mValues[i];
         }
@@ -116,9 +162,16 @@ public:
         return result;
     }
 
-    Vector operator-(const Vector& other) const {
+    constexpr Vector operator-(const Vector& other) const {
         Vector result{};
 
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(result.mValues.data(), SIMD::sub(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return result;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             result.mValues[i] = mValues[i] - other.mValues[i];
         }
@@ -126,9 +179,16 @@ public:
         return result;
     }
 
-    Vector operator*(const Vector& other) const {
+    constexpr Vector operator*(const Vector& other) const {
         Vector result{};
 
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(result.mValues.data(), SIMD::mul(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return result;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             result.mValues[i] = mValues[i] * other.mValues[i];
         }
@@ -136,9 +196,16 @@ public:
         return result;
     }
 
-    Vector operator*(Number scalar) const {
+    constexpr Vector operator*(T scalar) const {
         Vector result{};
 
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(result.mValues.data(), SIMD::mul(SIMD::load(mValues.data()), SIMD::splat(scalar)));
+                return result;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             result.mValues[i] = mValues[i] * scalar;
         }
@@ -146,9 +213,16 @@ public:
         return result;
     }
 
-    Vector operator/(const Vector& other) const {
+    constexpr Vector operator/(const Vector& other) const {
         Vector result{};
 
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(result.mValues.data(), SIMD::div(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return result;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             result.mValues[i] = mValues[i] / other.mValues[i];
         }
@@ -156,9 +230,16 @@ public:
         return result;
     }
 
-    Vector operator/(Number scalar) const {
+    constexpr Vector operator/(T scalar) const {
         Vector result{};
 
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(result.mValues.data(), SIMD::div(SIMD::load(mValues.data()), SIMD::splat(scalar)));
+                return result;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             result.mValues[i] = mValues[i] / scalar;
         }
@@ -166,15 +247,22 @@ public:
         return result;
     }
 
-    Vector operator+() const {
+    constexpr Vector operator+() const {
         return (*this);
     }
 
-    Vector operator-() const {
+    constexpr Vector operator-() const {
         return (*this) * -1;
     }
 
-    Vector& operator+=(const Vector& other) {
+    constexpr Vector& operator+=(const Vector& other) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::add(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] += other.mValues[i];
         }
@@ -182,7 +270,14 @@ public:
         return *this;
     }
 
-    Vector& operator+=(Number scalar) {
+    constexpr Vector& operator+=(T scalar) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::add(SIMD::load(mValues.data()), SIMD::splat(scalar)));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] += scalar;
         }
@@ -190,7 +285,14 @@ public:
         return *this;
     }
 
-    Vector& operator-=(const Vector& other) {
+    constexpr Vector& operator-=(const Vector& other) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::sub(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] -= other.mValues[i];
         }
@@ -198,7 +300,14 @@ public:
         return *this;
     }
 
-    Vector& operator-=(Number scalar) {
+    constexpr Vector& operator-=(T scalar) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::sub(SIMD::load(mValues.data()), SIMD::splat(scalar)));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] -= scalar;
         }
@@ -206,7 +315,14 @@ public:
         return *this;
     }
 
-    Vector& operator*=(const Vector& other) {
+    constexpr Vector& operator*=(const Vector& other) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::mul(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] *= other.mValues[i];
         }
@@ -214,7 +330,14 @@ public:
         return *this;
     }
 
-    Vector& operator*=(Number scalar) {
+    constexpr Vector& operator*=(T scalar) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::mul(SIMD::load(mValues.data()), SIMD::splat(scalar)));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] *= scalar;
         }
@@ -222,7 +345,14 @@ public:
         return *this;
     }
 
-    Vector& operator/=(const Vector& other) {
+    constexpr Vector& operator/=(const Vector& other) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::div(SIMD::load(mValues.data()), SIMD::load(other.mValues.data())));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] /= other.mValues[i];
         }
@@ -230,7 +360,14 @@ public:
         return *this;
     }
 
-    Vector& operator/=(Number scalar) {
+    constexpr Vector& operator/=(T scalar) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::div(SIMD::load(mValues.data()), SIMD::splat(scalar)));
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] /= scalar;
         }
@@ -238,7 +375,23 @@ public:
         return *this;
     }
 
-    bool operator==(const Vector& other) {
+    /* this += other * scalar in a single pass, with no temporary for the product */
+    constexpr Vector& addScaled(const Vector& other, T scalar) {
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::store(mValues.data(), SIMD::add(SIMD::load(mValues.data()), SIMD::mul(SIMD::load(other.mValues.data()), SIMD::splat(scalar))));
+                return *this;
+            }
+        }
+
+        for (size_t i{ 0 }; i < N; ++i) {
+            mValues[i] += other.mValues[i] * scalar;
+        }
+
+        return *this;
+    }
+
+    constexpr bool operator==(const Vector& other) const {
         for (size_t i{ 0 }; i < N; ++i) {
             if (mValues[i] != other.mValues[i])
                 return false;
@@ -247,7 +400,7 @@ public:
         return true;
     }
 
-    bool operator!=(const Vector& other) {
+    constexpr bool operator!=(const Vector& other) const {
         for (size_t i{ 0 }; i < N; ++i) {
             if (mValues[i] != other.mValues[i])
                 return true;
@@ -256,11 +409,11 @@ public:
         return false;
     }
 
-    const Number& operator[](size_t i) const {
+    constexpr const T& operator[](size_t i) const {
         return mValues[i];
     }
     
-    Number& operator[](size_t i) {
+    constexpr T& operator[](size_t i) {
         return mValues[i];
     }
 
@@ -268,25 +421,19 @@ public:
         Vector result{};
 
         for (size_t i{ 0 }; i < N; ++i) {
-            result.mValues[i] = abs(mValues[i]);
+            result.mValues[i] = std::abs(mValues[i]);
         }
 
         return result;
     }
 
-    Number magnitude() const {
-        Number sum{ 0 };
-
-        for (Number value : mValues) {
-            sum += powf(value, 2.0f);
-        }
-
-        return sqrtf(sum);
+    T magnitude() const {
+        return std::sqrt(dot(*this, *this));
     }
 
     Vector normalized() const {
         Vector result{};
-        Number m = magnitude();
+        T m = magnitude();
 
         for (size_t i{ 0 }; i < N; ++i) {
             result.mValues[i] = mValues[i] / m;
@@ -296,21 +443,21 @@ public:
     }
 
     void normalize() {
-        Number m = magnitude();
+        T m = magnitude();
         for (size_t i{ 0 }; i < N; ++i) {
             mValues[i] /= m;
         }
     }
 
-    Number dot(const Vector& other) const {
+    constexpr T dot(const Vector& other) const {
         return Vector::dot(*this, other);
     }
 
-    Vector cross(const Vector& other) const {
+    constexpr Vector cross(const Vector& other) const {
         return Vector::cross(*this, other);
     }
 
-    Vector lerp(const Vector& other, Number t) const {
+    constexpr Vector lerp(const Vector& other, T t) const {
         if (t < 0.0f)
             t = 0.0f;
         else if (t > 1.0f)
@@ -320,12 +467,83 @@ public:
     }
 };
 
-template<size_t M, size_t N = M>
+using Position = Vector<3, PositionNumber>;
+
+template<size_t M, size_t N = M, typename T = Number>
 class Matrix {
 private:
-    std::array<Number, M * N> mValues{};
+    std::array<T, M * N> mValues{};
+
+    /* float 4x4 products and transposes go through the SIMD kernels in simd.h when the target has them */
+    static constexpr bool Wide{ M == 4 && N == 4 && SIMD::Enabled && std::is_same_v<T, float> };
+
+    /* builds [B | -B t] from an already inverted 3x3 block B and the original translation t */
+    static constexpr Matrix fromBlock(const std::array<T, 9>& b, T tx, T ty, T tz) {
+        return Matrix{
+            b[0], b[1], b[2], -((b[0] * tx) + (b[1] * ty) + (b[2] * tz)),
+            b[3], b[4], b[5], -((b[3] * tx) + (b[4] * ty) + (b[5] * tz)),
+            b[6], b[7], b[8], -((b[6] * tx) + (b[7] * ty) + (b[8] * tz)),
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+    }
+
+    /* the six 2x2 determinants of rows 0-1 (s) and rows 2-3 (c) of a 4x4 */
+    constexpr void subDeterminants(T (&s)[6], T (&c)[6]) const {
+        const auto& a{ mValues };
+
+        s[0] = (a[0] * a[5]) - (a[4] * a[1]);
+        s[1] = (a[0] * a[6]) - (a[4] * a[2]);
+        s[2] = (a[0] * a[7]) - (a[4] * a[3]);
+        s[3] = (a[1] * a[6]) - (a[5] * a[2]);
+        s[4] = (a[1] * a[7]) - (a[5] * a[3]);
+        s[5] = (a[2] * a[7]) - (a[6] * a[3]);
+
+        c[5] = (a[10] * a[15]) - (a[14] * a[11]);
+        c[4] = (a[9] * a[15]) - (a[13] * a[11]);
+        c[3] = (a[9] * a[14]) - (a[13] * a[10]);
+        c[2] = (a[8] * a[15]) - (a[12] * a[11]);
+        c[1] = (a[8] * a[14]) - (a[12] * a[10]);
+        c[0] = (a[8] * a[13]) - (a[12] * a[9]);
+    }
+
+    /* in-place LU decomposition with partial pivoting, returns the sign of the row permutation */
+    constexpr T decompose(std::array<size_t, M>& pivots) {
+        T sign{ 1.0f };
+
+        for (size_t i{ 0 }; i < M; ++i) {
+            pivots[i] = i;
+        }
+
+        for (size_t k{ 0 }; k < M; ++k) {
+            size_t pivot{ k };
+            for (size_t i{ k + 1 }; i < M; ++i) {
+                T candidate{ mValues[(i * M) + k] }, best{ mValues[(pivot * M) + k] };
+                if ((candidate < 0.0f ? -candidate : candidate) > (best < 0.0f ? -best : best)) {
+                    pivot = i;
+                }
+            }
+
+            if (pivot != k) {
+                std::swap_ranges(mValues.begin() + static_cast<std::ptrdiff_t>(k * M), mValues.begin() + static_cast<std::ptrdiff_t>((k + 1) * M),
+                                 mValues.begin() + static_cast<std::ptrdiff_t>(pivot * M));
+                std::swap(pivots[k], pivots[pivot]);
+                sign = -sign;
+            }
+
+            for (size_t i{ k + 1 }; i < M; ++i) {
+                T factor{ mValues[(i * M) + k] / mValues[k * (M + 1)] };
+                mValues[(i * M) + k] = factor;
+
+                for (size_t j{ k + 1 }; j < M; ++j) {
+                    mValues[(i * M) + j] -= factor * mValues[(k * M) + j];
+                }
+            }
+        }
+
+        return sign;
+    }
 public:
-    static Matrix identity() {
+    static constexpr Matrix identity() {
         static_assert(M == N, "cannot create rectangular identity matrix");
         Matrix result{};
 
@@ -336,30 +554,29 @@ public:
         return result;
     }
 
-    Matrix(Number value = 0.0f) : mValues {} {
+    constexpr Matrix(T value = 0.0f) : mValues {} {
         static_assert(M > 0 && N > 0, "cannot have zero width matrix");
         mValues.fill(value);
     }
 
-    template<typename... T>
-    Matrix(T... values) : mValues{ values... } {
+    template<typename... Values> requires (sizeof...(Values) == M * N && M * N > 1)
+    constexpr Matrix(Values... values) : mValues{ values... } {
         static_assert(M > 0 && N > 0, "cannot have zero width matrix");
-        static_assert(sizeof...(values) == M * N, "invalid number of parameters");
     }
 
-    size_t size() const { return M * N; }
-    size_t rows() const { return M; }
-    size_t columns() const { return N; }
+    constexpr size_t size() const { return M * N; }
+    constexpr size_t rows() const { return M; }
+    constexpr size_t columns() const { return N; }
 
-    const std::array<Number, M * N>& data() const {
+    constexpr const std::array<T, M * N>& data() const {
         return mValues;
     }
 
-    std::array<Number, N * N>& data() {
+    constexpr std::array<T, M * N>& data() {
         return mValues;
     }
 
-    Matrix operator+(const Matrix& other) const {
+    constexpr Matrix operator+(const Matrix& other) const {
         Matrix result{};
         for (size_t i{ 0 }; i < M * N; ++i) {
             result.mValues[i] = mValues[i] + other.mValues[i];
@@ -368,7 +585,7 @@ public:
         return result;
     }
 
-    Matrix operator-(const Matrix& other) const {
+    constexpr Matrix operator-(const Matrix& other) const {
         Matrix result{};
         for (size_t i{ 0 }; i < M * N; ++i) {
             result.mValues[i] = mValues[i] - other.mValues[i];
@@ -378,14 +595,21 @@ public:
     }
 
     template <size_t N2>
-    Matrix<M, N2> operator*(const Matrix<N, N2> other) const {
+    constexpr Matrix<M, N2, T> operator*(const Matrix<N, N2, T> other) const {
+
+        Matrix<M, N2, T> result{};
 
-        Matrix<M, N2> result{};
+        if constexpr (Wide && N2 == 4) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::multiplyMatrix4(mValues.data(), other.data().data(), result.data().data());
+                return result;
+            }
+        }
 
         for (size_t i{ 0 }; i < M * N2; ++i) {
             size_t r{ i / N2 }, c{ i % N2 };
 
-            Number sum{ 0 };
+            T sum{ 0 };
             for (size_t j{ 0 }; j < N; ++j) {
                 sum += at(r, j) * other.at(j, c);
             }
@@ -396,11 +620,18 @@ public:
         return result;
     }
 
-    Vector<M> operator*(const Vector<N> other) const {
-        Vector<M> result{};
+    constexpr Vector<M, T> operator*(const Vector<N, T> other) const {
+        Vector<M, T> result{};
+
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::transformVector4(mValues.data(), other.data().data(), result.data().data());
+                return result;
+            }
+        }
 
         for (size_t i{ 0 }; i < M; ++i) {
-            Number sum{ 0 };
+            T sum{ 0 };
             for (size_t j{ 0 }; j < N; ++j) {
                 sum += at(i, j) * other[j];
             }
@@ -411,7 +642,7 @@ public:
         return result; 
     }
 
-    Matrix operator*(Number scalar) const {
+    constexpr Matrix operator*(T scalar) const {
         Matrix result{};
         for (size_t i{ 0 }; i < M * N; ++i) {
             result.mValues[i] = mValues[i] * scalar;
@@ -420,7 +651,7 @@ public:
         return result;   
     }
 
-    Matrix operator/(Number scalar) const {
+    constexpr Matrix operator/(T scalar) const {
         Matrix result{};
         for (size_t i{ 0 }; i < M * N; ++i) {
             result.mValues[i] = mValues[i] / scalar;
@@ -429,7 +660,7 @@ public:
         return result;   
     }
 
-    Matrix& operator+=(Number scalar) {
+    constexpr Matrix& operator+=(T scalar) {
         for (size_t i{ 0 }; i < M * N; ++i) {
             mValues[i] += scalar;
         }
@@ -437,7 +668,7 @@ public:
         return *this;
     }
 
-    Matrix& operator-=(Number scalar) {
+    constexpr Matrix& operator-=(T scalar) {
         for (size_t i{ 0 }; i < M * N; ++i) {
             mValues[i] -= scalar;
         }
@@ -445,13 +676,22 @@ public:
         return *this;
     }
 
-    Matrix& operator*=(const Matrix<M, M>& other) {
+    constexpr Matrix& operator*=(const Matrix<M, M, T>& other) {
         Matrix result{};
 
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                /* note the order: this becomes other * this */
+                SIMD::multiplyMatrix4(other.mValues.data(), mValues.data(), result.mValues.data());
+                *this = result;
+                return *this;
+            }
+        }
+
         for (size_t i{ 0 }; i < M * N; ++i) {
             size_t r{ i / N }, c{ i % N };
 
-            Number sum{ 0 };
+            T sum{ 0 };
             for (size_t j{ 0 }; j < M; ++j) {
                 sum += other.at(r, j) * at(j, c);
             }
@@ -463,7 +703,7 @@ public:
         return *this;
     }
 
-    Matrix& operator*=(Number scalar) {
+    constexpr Matrix& operator*=(T scalar) {
         for (size_t i{ 0 }; i < M * N; ++i) {
             mValues[i] *= scalar;
         }
@@ -471,7 +711,7 @@ public:
         return *this;
     }
 
-    Matrix& operator/=(Number scalar) {
+    constexpr Matrix& operator/=(T scalar) {
         for (size_t i{ 0 }; i < M * N; ++i) {
             mValues[i] /= scalar;
         }
@@ -479,26 +719,26 @@ public:
         return *this;
     }
 
-    Number& operator[](size_t i) {
+    constexpr T& operator[](size_t i) {
         return mValues[i];
     }
 
-    const Number& operator[](size_t i) const {
+    constexpr const T& operator[](size_t i) const {
         return mValues[i];
     }
 
-    Number at(size_t r, size_t c) const {
+    constexpr T at(size_t r, size_t c) const {
         return mValues[c + (r * N)];
     }
 
-    Number& at(size_t r, size_t c) {
+    constexpr T& at(size_t r, size_t c) {
         return mValues[c + (r * N)];
     }
 
-    Matrix<M-1, N-1> minor(size_t r, size_t c) const {
+    constexpr Matrix<M-1, N-1, T> minor(size_t r, size_t c) const {
         static_assert(M > 1 && N > 1, "cannot take minor of single width matrix");
 
-        Matrix<M-1, N-1> result{};
+        Matrix<M-1, N-1, T> result{};
 
         for (size_t i{ 0 }; i < M * N; ++i) {
             size_t x{ i / N }, y { i % N };
@@ -517,26 +757,61 @@ public:
         return result;
     }
     
-    Number determinant() const {
+    constexpr T determinant() const {
         static_assert(M == N, "cannot take determinant of rectangular matrix");
 
         if constexpr (M == 1) {
             return mValues[0];
         } else if constexpr (M == 2) {
             return (mValues[0] * mValues[3]) - (mValues[1] * mValues[2]);
+        } else if constexpr (M == 3) {
+            const auto& a{ mValues };
+            return (a[0] * ((a[4] * a[8]) - (a[5] * a[7])))
+                 + (a[1] * ((a[5] * a[6]) - (a[3] * a[8])))
+                 + (a[2] * ((a[3] * a[7]) - (a[4] * a[6])));
+        } else if constexpr (M == 4) {
+            T s[6], c[6];
+            subDeterminants(s, c);
+            return (s[0] * c[5]) - (s[1] * c[4]) + (s[2] * c[3]) + (s[3] * c[2]) - (s[4] * c[1]) + (s[5] * c[0]);
         } else {
-            Number sum{ 0 };
+            Matrix lu{ *this };
+            std::array<size_t, M> pivots{};
+            T sign{ lu.decompose(pivots) };
 
             for (size_t i{ 0 }; i < M; ++i) {
-                sum += (minor(0, i).determinant() * (i % 2 == 0 ? 1.0f : -1.0f)) * mValues[i];
+                sign *= lu.mValues[i * (M + 1)];
+            }
+
+            return sign;
+        }
+    }
+
+    /* cofactor expansion through minor(), kept as the reference for the closed forms below */
+    constexpr T adjointDeterminant() const {
+        static_assert(M == N, "cannot take determinant of rectangular matrix");
+
+        if constexpr (M <= 2) {
+            return determinant();
+        } else {
+            T sum{ 0 };
+
+            for (size_t i{ 0 }; i < M; ++i) {
+                sum += (minor(0, i).adjointDeterminant() * (i % 2 == 0 ? 1.0f : -1.0f)) * mValues[i];
             }
 
             return sum;
         }
     }
 
-    Matrix<N, M> transpose() const {
-        Matrix<N, M> result{};
+    constexpr Matrix<N, M, T> transpose() const {
+        Matrix<N, M, T> result{};
+
+        if constexpr (Wide) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::transposeMatrix4(mValues.data(), result.data().data());
+                return result;
+            }
+        }
 
         for (size_t i{ 0 }; i < M * N; ++i) {
             result[i] = mValues[(N * (i % M)) + (i / M)];
@@ -545,61 +820,198 @@ public:
         return result;
     }
 
-    Matrix<N, M> adjoint() const {
+    constexpr Matrix<N, M, T> adjoint() const {
         Matrix result{};
 
         for (size_t i{ 0 }; i < N * M; ++i) {
-            result.mValues[i] = minor(i / N, i % N).determinant() * ((i % 2 == 0 ? 1.0f : -1.0f) * ((i / N) % 2 == 0 ? 1.0f : -1.0f));
+            result.mValues[i] = minor(i / N, i % N).adjointDeterminant() * (((i / N) + (i % N)) % 2 == 0 ? 1.0f : -1.0f);
         }
 
         return result.transpose();
     }
 
-    Matrix<N, M> inverse() const {
-        return adjoint() / determinant();
+    constexpr Matrix<N, M, T> inverse() const {
+        static_assert(M == N, "cannot invert rectangular matrix");
+        const auto& a{ mValues };
+
+        if constexpr (M == 1) {
+            return Matrix{ 1.0f / a[0] };
+        } else if constexpr (M == 2) {
+            T inv{ 1.0f / determinant() };
+            return Matrix{ a[3] * inv, -a[1] * inv, -a[2] * inv, a[0] * inv };
+        } else if constexpr (M == 3) {
+            T c0{ (a[4] * a[8]) - (a[5] * a[7]) };
+            T c1{ (a[5] * a[6]) - (a[3] * a[8]) };
+            T c2{ (a[3] * a[7]) - (a[4] * a[6]) };
+            T inv{ 1.0f / ((a[0] * c0) + (a[1] * c1) + (a[2] * c2)) };
+
+            return Matrix{
+                c0 * inv, ((a[2] * a[7]) - (a[1] * a[8])) * inv, ((a[1] * a[5]) - (a[2] * a[4])) * inv,
+                c1 * inv, ((a[0] * a[8]) - (a[2] * a[6])) * inv, ((a[2] * a[3]) - (a[0] * a[5])) * inv,
+                c2 * inv, ((a[1] * a[6]) - (a[0] * a[7])) * inv, ((a[0] * a[4]) - (a[1] * a[3])) * inv
+            };
+        } else if constexpr (M == 4) {
+            /* cofactors from the 2x2 sub-determinants of the top and bottom row pairs */
+            T s[6], c[6];
+            subDeterminants(s, c);
+            T inv{ 1.0f / ((s[0] * c[5]) - (s[1] * c[4]) + (s[2] * c[3]) + (s[3] * c[2]) - (s[4] * c[1]) + (s[5] * c[0])) };
+
+            return Matrix{
+                ( (a[5] * c[5]) - (a[6] * c[4]) + (a[7] * c[3])) * inv,
+                (-(a[1] * c[5]) + (a[2] * c[4]) - (a[3] * c[3])) * inv,
+                ( (a[13] * s[5]) - (a[14] * s[4]) + (a[15] * s[3])) * inv,
+                (-(a[9] * s[5]) + (a[10] * s[4]) - (a[11] * s[3])) * inv,
+
+                (-(a[4] * c[5]) + (a[6] * c[2]) - (a[7] * c[1])) * inv,
+                ( (a[0] * c[5]) - (a[2] * c[2]) + (a[3] * c[1])) * inv,
+                (-(a[12] * s[5]) + (a[14] * s[2]) - (a[15] * s[1])) * inv,
+                ( (a[8] * s[5]) - (a[10] * s[2]) + (a[11] * s[1])) * inv,
+
+                ( (a[4] * c[4]) - (a[5] * c[2]) + (a[7] * c[0])) * inv,
+                (-(a[0] * c[4]) + (a[1] * c[2]) - (a[3] * c[0])) * inv,
+                ( (a[12] * s[4]) - (a[13] * s[2]) + (a[15] * s[0])) * inv,
+                (-(a[8] * s[4]) + (a[9] * s[2]) - (a[11] * s[0])) * inv,
+
+                (-(a[4] * c[3]) + (a[5] * c[1]) - (a[6] * c[0])) * inv,
+                ( (a[0] * c[3]) - (a[1] * c[1]) + (a[2] * c[0])) * inv,
+                (-(a[12] * s[3]) + (a[13] * s[1]) - (a[14] * s[0])) * inv,
+                ( (a[8] * s[3]) - (a[9] * s[1]) + (a[10] * s[0])) * inv
+            };
+        } else {
+            Matrix lu{ *this };
+            std::array<size_t, M> pivots{};
+            lu.decompose(pivots);
+
+            Matrix result{};
+
+            /* solve LU x = P e_j for every column j of the identity */
+            for (size_t j{ 0 }; j < M; ++j) {
+                std::array<T, M> x{};
+
+                for (size_t i{ 0 }; i < M; ++i) {
+                    T sum{ pivots[i] == j ? 1.0f : 0.0f };
+                    for (size_t k{ 0 }; k < i; ++k) {
+                        sum -= lu.mValues[(i * M) + k] * x[k];
+                    }
+                    x[i] = sum;
+                }
+
+                for (size_t i{ M }; i-- > 0;) {
+                    T sum{ x[i] };
+                    for (size_t k{ i + 1 }; k < M; ++k) {
+                        sum -= lu.mValues[(i * M) + k] * x[k];
+                    }
+                    x[i] = sum / lu.mValues[i * (M + 1)];
+                }
+
+                for (size_t i{ 0 }; i < M; ++i) {
+                    result.mValues[(i * M) + j] = x[i];
+                }
+            }
+
+            return result;
+        }
+    }
+
+    /* the original cofactor path, slow but independent of the closed forms */
+    constexpr Matrix<N, M, T> adjointInverse() const {
+        return adjoint() / adjointDeterminant();
+    }
+
+    /* inverse of a transform whose bottom row is 0 0 0 1: inverts the 3x3 block and maps the translation back */
+    constexpr Matrix<N, M, T> inverseAffine() const {
+        static_assert(M == 4 && N == 4, "affine inverse is only defined for 4x4 transforms");
+        const auto& a{ mValues };
+
+        Matrix<3, 3, T> block{ Matrix<3, 3, T>{ a[0], a[1], a[2], a[4], a[5], a[6], a[8], a[9], a[10] }.inverse() };
+        const auto& b{ block.data() };
+
+        return fromBlock(b, a[3], a[7], a[11]);
+    }
+
+    /* inverse of a rotation plus translation with no scale: the rotation is orthonormal so it just transposes */
+    constexpr Matrix<N, M, T> inverseRigid() const {
+        static_assert(M == 4 && N == 4, "rigid inverse is only defined for 4x4 transforms");
+        const auto& a{ mValues };
+
+        return fromBlock(std::array<T, 9>{ a[0], a[4], a[8], a[1], a[5], a[9], a[2], a[6], a[10] }, a[3], a[7], a[11]);
     }
 };
 
-class Quaternion {
+template <typename T = Number>
+class BasicQuaternion {
 private:
-    Number mW{}, mX{}, mY{}, mZ{};
+    T mW{}, mX{}, mY{}, mZ{};
+
+    /* slerp without the shorter-arc flip or the clamp, squad aligns the signs itself and blends past the ends */
+    BasicQuaternion slerpUnclamped(const BasicQuaternion& other, T t) const {
+        T cosine{ clamp(dot(other), T{ -1 }, T{ 1 }) };
+        if (cosine > 0.9995f) {
+            BasicQuaternion raw{ (*this * (1.0f - t)) + (other * t) };
+            return raw.normalized();
+        }
+
+        if (cosine < -0.9995f) {
+            /* nearly antiparallel, the arc is half a great circle in any direction; take it through a perpendicular */
+            BasicQuaternion perpendicular{ -mX, mW, -mZ, mY };
+            return (*this * std::cos(t * Pi)) + (perpendicular * std::sin(t * Pi));
+        }
+
+        T theta{ std::acos(cosine) };
+        return ((*this * std::sin((1.0f - t) * theta)) + (other * std::sin(t * theta))) / std::sin(theta);
+    }
 public:
-    Quaternion() : mW{ 1.0f }, mX{ 0.0f }, mY{ 0.0f }, mZ{ 0.0f } {}
-    Quaternion(Number w, Number x, Number y, Number z) : mW{ w }, mX{ x }, mY{ y }, mZ{ z } {}
-
-    Quaternion(Number x, Number y, Number z)
-        : mW{ (cosf(x * 0.5f) * cosf(y * 0.5f) * cosf(z * 0.5f)) + (sinf(x * 0.5f) * sinf(y * 0.5f) * sinf(z * 0.5f)) },
-          mX{ (sinf(x * 0.5f) * cosf(y * 0.5f) * cosf(z * 0.5f)) - (cosf(x * 0.5f) * sinf(y * 0.5f) * sinf(z * 0.5f)) },
-          mY{ (cosf(x * 0.5f) * sinf(y * 0.5f) * cosf(z * 0.5f)) + (sinf(x * 0.5f) * cosf(y * 0.5f) * sinf(z * 0.5f)) },
-          mZ{ (cosf(x * 0.5f) * cosf(y * 0.5f) * sinf(z * 0.5f)) - (sinf(x * 0.5f) * sinf(y * 0.5f) * cosf(z * 0.5f)) } {}
-    Quaternion(Vector<3> euler) : Quaternion(euler.x(), euler.y(), euler.z()) {}
-
-    Number w() const { return mW; }
-    void w(Number value) { mW = value; }
-    Number x() const { return mX; }
-    void x(Number value) { mX = value; }
-    Number y() const { return mY; }
-    void y(Number value) { mY = value; }
-    Number z() const { return mZ; }
-    void z(Number value) { mZ = value; }
-
-    Quaternion operator+(const Quaternion& other) const {
+    constexpr BasicQuaternion() : mW{ 1.0f }, mX{ 0.0f }, mY{ 0.0f }, mZ{ 0.0f } {}
+    constexpr BasicQuaternion(T w, T x, T y, T z) : mW{ w }, mX{ x }, mY{ y }, mZ{ z } {}
+
+    /* Euler angles in radians, see Fast::fromEuler for the approximate version */
+    BasicQuaternion(T x, T y, T z) {
+        T cx{ std::cos(x * 0.5f) }, sx{ std::sin(x * 0.5f) };
+        T cy{ std::cos(y * 0.5f) }, sy{ std::sin(y * 0.5f) };
+        T cz{ std::cos(z * 0.5f) }, sz{ std::sin(z * 0.5f) };
+
+        mW = (cx * cy * cz) + (sx * sy * sz);
+        mX = (sx * cy * cz) - (cx * sy * sz);
+        mY = (cx * sy * cz) + (sx * cy * sz);
+        mZ = (cx * cy * sz) - (sx * sy * cz);
+    }
+    BasicQuaternion(Vector<3, T> euler) : BasicQuaternion(euler.x(), euler.y(), euler.z()) {}
+
+    constexpr T w() const { return mW; }
+    constexpr void w(T value) { mW = value; }
+    constexpr T x() const { return mX; }
+    constexpr void x(T value) { mX = value; }
+    constexpr T y() const { return mY; }
+    constexpr void y(T value) { mY = value; }
+    constexpr T z() const { return mZ; }
+    constexpr void z(T value) { mZ = value; }
+
+    constexpr bool operator==(const BasicQuaternion& other) const = default;
+
+    constexpr BasicQuaternion operator+(const BasicQuaternion& other) const {
         return { mW + other.mW, mX + other.mX, mY + other.mY, mZ + other.mZ };
     }
 
-    Quaternion operator+(Number scalar) const {
+    constexpr BasicQuaternion operator+(T scalar) const {
         return { mW + scalar, mX, mY, mZ };
     }
 
-    Quaternion operator-(const Quaternion& other) const {
+    constexpr BasicQuaternion operator-(const BasicQuaternion& other) const {
         return { mW - other.mW, mX - other.mX, mY - other.mY, mZ - other.mZ };
     }
 
-    Quaternion operator-(Number scalar) const {
+    constexpr BasicQuaternion operator-(T scalar) const {
         return { mW - scalar, mX, mY, mZ };
     }
 
-    Quaternion operator*(const Quaternion& other) const {
+    constexpr BasicQuaternion operator*(const BasicQuaternion& other) const {
+        if constexpr (SIMD::Enabled && std::is_same_v<T, float>) {
+            if (!std::is_constant_evaluated()) {
+                SIMD::Float4 q{ SIMD::multiplyQuaternion(SIMD::set(mW, mX, mY, mZ), SIMD::set(other.mW, other.mX, other.mY, other.mZ)) };
+                return { SIMD::lane<0>(q), SIMD::lane<1>(q), SIMD::lane<2>(q), SIMD::lane<3>(q) };
+            }
+        }
+
         return {
             (mW * other.mW) - (mX * other.mX) - (mY * other.mY) - (mZ * other.mZ),
             (mX * other.mW) + (mW * other.mX) + (mY * other.mZ) - (mZ * other.mY),
@@ -608,7 +1020,7 @@ public:
         };
     }
 
-    Quaternion operator*(Number scalar) const {
+    constexpr BasicQuaternion operator*(T scalar) const {
         return {
             mW * scalar,
             mX * scalar,
@@ -617,11 +1029,11 @@ public:
         };
     }
 
-    Quaternion operator/(const Quaternion& other) const {
+    BasicQuaternion operator/(const BasicQuaternion& other) const {
         return *this * other.inverse();
     }
 
-    Quaternion operator/(Number scalar) const {
+    constexpr BasicQuaternion operator/(T scalar) const {
         return {
             mW / scalar,
             mX / scalar,
@@ -630,7 +1042,7 @@ public:
         };
     }
 
-    Quaternion& operator+=(const Quaternion& other) {
+    constexpr BasicQuaternion& operator+=(const BasicQuaternion& other) {
         mW += other.mW;
         mX += other.mX;
         mY += other.mY;
@@ -639,13 +1051,13 @@ public:
         return *this; 
     }
 
-    Quaternion& operator+=(Number scalar) {
+    constexpr BasicQuaternion& operator+=(T scalar) {
         mW += scalar;
 
         return *this;
     }
     
-    Quaternion& operator-=(const Quaternion& other) {
+    constexpr BasicQuaternion& operator-=(const BasicQuaternion& other) {
         mW -= other.mW;
         mX -= other.mX;
         mY -= other.mY;
@@ -654,19 +1066,19 @@ public:
         return *this; 
     }
     
-    Quaternion& operator-=(Number scalar) {
+    constexpr BasicQuaternion& operator-=(T scalar) {
         mW -= scalar;
         
         return *this;
     }
     
 
-    Quaternion& operator*=(const Quaternion& other) {
+    constexpr BasicQuaternion& operator*=(const BasicQuaternion& other) {
         *this = *this * other;
         return *this;
     }
 
-    Quaternion& operator*=(Number scalar) {
+    constexpr BasicQuaternion& operator*=(T scalar) {
         mW *= scalar;
         mX *= scalar;
         mY *= scalar;
@@ -675,12 +1087,12 @@ public:
         return *this;
     }
     
-    Quaternion& operator/=(const Quaternion& other) {
+    BasicQuaternion& operator/=(const BasicQuaternion& other) {
         *this = *this / other;
         return *this;
     }
 
-    Quaternion& operator/=(Number scalar) {
+    constexpr BasicQuaternion& operator/=(T scalar) {
         mW /= scalar;
         mX /= scalar;
         mY /= scalar;
@@ -689,30 +1101,30 @@ public:
         return *this;
     }
 
-    Vector<3> toEuler() const {
-        Number t0{ 2.0f * ((mW * mX) + (mY * mZ)) };
-        Number t1{ 1.0f - (2.0f * ((mX * mX) + (mY * mY))) };
+    Vector<3, T> toEuler() const {
+        T t0{ 2.0f * ((mW * mX) + (mY * mZ)) };
+        T t1{ 1.0f - (2.0f * ((mX * mX) + (mY * mY))) };
 
-        Number x{ atan2f32(t0, t1) };
+        T x{ std::atan2(t0, t1) };
 
-        Number t2{ 2.0f * ((mW * mY) - (mZ * mX)) };
+        T t2{ 2.0f * ((mW * mY) - (mZ * mX)) };
         if (t2 > 1.0f)
             t2 = 1.0f;
         else if (t2 < -1.0f)
             t2 = -1.0f;
         
-        Number y{ asinf32(t2) };
+        T y{ std::asin(t2) };
 
-        Number t3{ 2.0f * ((mW * mZ) + (mX * mY)) };
-        Number t4{ 1.0f - (2.0f * ((mY * mY) + (mZ * mZ))) };
+        T t3{ 2.0f * ((mW * mZ) + (mX * mY)) };
+        T t4{ 1.0f - (2.0f * ((mY * mY) + (mZ * mZ))) };
         
-        Number z{ atan2f32(t3, t4) };
+        T z{ std::atan2(t3, t4) };
 
         return { x, y, z };
     }
 
-    Matrix<4> toMatrix() const {
-        Number x2{ mX * mX }, y2{ mY * mY }, z2{ mZ * mZ };
+    constexpr Matrix<4, 4, T> toMatrix() const {
+        T x2{ mX * mX }, y2{ mY * mY }, z2{ mZ * mZ };
         return {
             1.0f - (2.0f * y2) - (2.0f * z2), (2.0f * mX * mY) - (2.0f * mW * mZ), (2.0f * mX * mZ) + (2.0f * mW * mY), 0.0f,
             (2.0f * mX * mY) + (2.0f * mW * mZ), 1.0f - (2.0f * x2) - (2.0f * z2), (2.0f * mY * mZ) - (2.0f * mW * mX), 0.0f,
@@ -721,11 +1133,11 @@ public:
         };
     }
 
-    Number magnitude() const {
-        return sqrtf((mW * mW) + (mX * mX) + (mY * mY) + (mZ * mZ));
+    T magnitude() const {
+        return std::sqrt((mW * mW) + (mX * mX) + (mY * mY) + (mZ * mZ));
     }
 
-    Quaternion conjugate() const {
+    constexpr BasicQuaternion conjugate() const {
         return {
             mW,
             -mX,
@@ -734,12 +1146,12 @@ public:
         };
     }
 
-    Quaternion normalized() const {
+    BasicQuaternion normalized() const {
         return *this / magnitude();
     }
 
     void normalize() {
-        Number m{ magnitude() };
+        T m{ magnitude() };
 
         mW /= m;
         mX /= m;
@@ -747,29 +1159,106 @@ public:
         mZ /= m;
     }
 
-    Quaternion inverse() const {
-        return conjugate() / powf(magnitude(), 2.0f);
+    BasicQuaternion inverse() const {
+        return conjugate() / std::pow(magnitude(), T{ 2 });
     }
 
-    Number dot(const Quaternion& other) const {
+    constexpr T dot(const BasicQuaternion& other) const {
         return (mW * other.mW) + (mX * other.mX) + (mY * other.mY) + (mZ * other.mZ);
     }
     
-    Quaternion cross(const Quaternion& other) const {
+    constexpr BasicQuaternion cross(const BasicQuaternion& other) const {
         return (*this * other) + dot(other);
     }
 
-    Quaternion lerp(const Quaternion& other, Number t) const {
+    /* straight component blend, renormalized; takes the long way round when the inputs are in opposite hemispheres, see nlerp */
+    BasicQuaternion lerp(const BasicQuaternion& other, T t) const {
         if (t < 0.0f)
             t = 0.0f;
         else if (t > 1.0f)
             t = 1.0f;
 
-        Quaternion raw{ (*this * (1.0f - t)) + (other * t) };
+        BasicQuaternion raw{ (*this * (1.0f - t)) + (other * t) };
         return raw / raw.magnitude();
     }
+
+    /* v + w t + q x t with t = 2 (q x v), for unit quaternions; no matrix is built */
+    constexpr Vector<3, T> rotate(const Vector<3, T>& v) const {
+        Vector<3, T> axis{ mX, mY, mZ };
+        Vector<3, T> t{ Vector<3, T>::cross(axis, v) * 2.0f };
+        return v + (t * mW) + Vector<3, T>::cross(axis, t);
+    }
+
+    /* normalized blend along the shorter arc, not constant speed but cheap and close for small angles */
+    BasicQuaternion nlerp(const BasicQuaternion& other, T t) const {
+        t = clamp(t, T{ 0 }, T{ 1 });
+
+        T sign{ dot(other) < 0.0f ? -1.0f : 1.0f };
+        BasicQuaternion raw{ (*this * (1.0f - t)) + (other * (t * sign)) };
+        return raw.normalized();
+    }
+
+    /* constant angular speed along the shorter arc, falls back to nlerp when the two are nearly parallel */
+    BasicQuaternion slerp(const BasicQuaternion& other, T t) const {
+        t = clamp(t, T{ 0 }, T{ 1 });
+
+        T cosine{ dot(other) };
+        BasicQuaternion target{ other };
+        if (cosine < 0.0f) {
+            cosine = -cosine;
+            target = other * -1.0f;
+        }
+
+        if (cosine > 0.9995f)
+            return nlerp(target, t);
+
+        T theta{ std::acos(cosine) };
+        T sine{ std::sin(theta) };
+        return ((*this * std::sin((1.0f - t) * theta)) + (target * std::sin(t * theta))) / sine;
+    }
+
+    /* natural log of a unit quaternion, a pure quaternion holding half the rotation angle times the axis */
+    BasicQuaternion log() const {
+        T length{ std::sqrt((mX * mX) + (mY * mY) + (mZ * mZ)) };
+        if (length < 1e-6f)
+            return { 0.0f, mX, mY, mZ };
+
+        T scale{ std::atan2(length, mW) / length };
+        return { 0.0f, mX * scale, mY * scale, mZ * scale };
+    }
+
+    /* inverse of log() for pure quaternions */
+    BasicQuaternion exp() const {
+        T angle{ std::sqrt((mX * mX) + (mY * mY) + (mZ * mZ)) };
+        if (angle < 1e-6f)
+            return BasicQuaternion{ 1.0f, mX, mY, mZ }.normalized();
+
+        T scale{ std::sin(angle) / angle };
+        return { std::cos(angle), mX * scale, mY * scale, mZ * scale };
+    }
+
+    /* inner control point for `current` on the curve through previous, current and next, feed these to squad */
+    static BasicQuaternion squadControl(const BasicQuaternion& previous, const BasicQuaternion& current, const BasicQuaternion& next) {
+        BasicQuaternion inverse{ current.conjugate() };
+        BasicQuaternion toNext{ inverse * (current.dot(next) < 0.0f ? next * -1.0f : next) };
+        BasicQuaternion toPrevious{ inverse * (current.dot(previous) < 0.0f ? previous * -1.0f : previous) };
+
+        return current * ((toNext.log() + toPrevious.log()) * -0.25f).exp();
+    }
+
+    /* smooth spline between a and b with the control points from squadControl, C1 across consecutive segments */
+    static BasicQuaternion squad(const BasicQuaternion& a, const BasicQuaternion& b, const BasicQuaternion& controlA, const BasicQuaternion& controlB, T t) {
+        /* sign-align once so all three blends run the same way round; separate shorter-arc choices can disagree */
+        BasicQuaternion end{ a.dot(b) < 0.0f ? b * -1.0f : b };
+        BasicQuaternion innerA{ a.dot(controlA) < 0.0f ? controlA * -1.0f : controlA };
+        BasicQuaternion innerB{ end.dot(controlB) < 0.0f ? controlB * -1.0f : controlB };
+
+        return a.slerpUnclamped(end, t).slerpUnclamped(innerA.slerpUnclamped(innerB, t), 2.0f * t * (1.0f - t));
+    }
 };
 
+using Quaternion = BasicQuaternion<>;
+
 }
 
 #endif
\ No newline at end of file
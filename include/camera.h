@@ -3,34 +3,92 @@
 
 #include <bmath.h>
 #include <affine.h>
+#include <geometry.h>
 
 namespace BEG {
 
+/*
+ * Rendering happens relative to the camera (see relative()), so the view
+ * matrix only rotates and moving the camera invalidates nothing. The view,
+ * projection, their product, the inverses and the frustum are cached and
+ * rebuilt on the first query after the orientation, fov, aspect or clip
+ * planes change; every consumer in a frame shares the same copies.
+ */
 class Camera {
-private:
-    float mFov{};
 public:
-    Vector<3> position{};
-    Quaternion orientation{};
+    /* how the projection maps depth, the renderer sets up GL to match */
+    enum class DepthMode {
+        Standard,       /* OpenGL's -1..1 clip depth between the near and far planes, tested with GL_LEQUAL */
+        ReverseInfinite /* 1 at the near plane falling towards 0 at infinity, drawn with a 0..1 clip range, float depth and GL_GREATER */
+    };
+private:
+    struct Cache {
+        Matrix<4> view{}, inverseView{};
+        Matrix<4> projection{}, inverseProjection{};
+        Matrix<4> viewProjection{}, inverseViewProjection{};
+        Frustum frustum{};
+    };
+
+    float mFov{}, mAspect{ 1.0f }, mNear{ 0.1f }, mFar{ 100.0f };
+    DepthMode mDepthMode{ DepthMode::Standard };
+    Position mPosition{ 0.0f };
+    Quaternion mOrientation{ 0.0f, 0.0f, 0.0f };
 
-    Camera(float fov = toRadians(45.0f)) : mFov{ fov }, position{ 0.0f }, orientation{ 0.0f, 0.0f, 0.0f } {}
+    mutable Cache mCache{};
+    mutable bool mViewDirty{ true }, mProjectionDirty{ true };
 
-    float fov();
+    /* rebuild whatever is stale, called by every cached getter */
+    const Cache& cache() const;
+public:
+    Camera(float fov = toRadians(45.0f)) : mFov{ fov } {}
+
+    float fov() const;
     void fov(float value);
 
+    float aspect() const;
+    void aspect(float value);
+
+    float near() const;
+    /* ignored by DepthMode::ReverseInfinite, which has no far plane */
+    float far() const;
+    void clipPlanes(float near, float far);
+
+    DepthMode depthMode() const;
+    void depthMode(DepthMode value);
+    /* the clip range the depth mode projects into, for Frustum::fromMatrix */
+    Frustum::ClipDepth clipDepth() const;
+
+    const Position& position() const;
+    void position(const Position& value);
+    void translate(const Vector<3>& offset);
+
+    const Quaternion& orientation() const;
+    void orientation(const Quaternion& value);
+
     Vector<3> front() const;
     Vector<3> right() const;
     Vector<3> up() const;
 
+    /* a world position with the camera's taken out, subtracted before narrowing to Number */
+    Vector<3> relative(const Position& world) const;
+
+    /* world space, so this loses precision far from the origin */
     Matrix<4> transformationMatrix() const;
-    Matrix<4> viewMatrix() const;
 
+    /* cached, all for camera-relative positions */
+    const Matrix<4>& viewMatrix() const;
+    const Matrix<4>& inverseViewMatrix() const;
+    const Matrix<4>& projectionMatrix() const;
+    const Matrix<4>& inverseProjectionMatrix() const;
+    /* projection matrix * view matrix */
+    const Matrix<4>& viewProjectionMatrix() const;
+    const Matrix<4>& inverseViewProjectionMatrix() const;
+    const Frustum& frustum() const;
+
+    /* in the current depth mode */
     Matrix<4> perspectiveMatrix(float aspect, float near, float far) const;
-    
-    /* perspective matrix * view matrix */
-    Matrix<4> combinedMatrix(float aspect /* aspect ratio of output */, float near, float far) const;
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
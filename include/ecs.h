@@ -6,6 +6,9 @@
 #include <memory>
 #include <tuple>
 #include <optional>
+#include <typeinfo>
+
+#include <profiler.h>
 
 namespace BEG {
 
@@ -45,12 +48,13 @@ private:
     std::vector<Entity> mEntities{};
 
     std::vector<std::shared_ptr<SystemInterface>> mSystems{};
+    std::vector<const char*> mSystemNames{}; /* readable type names, used to label profiler scopes */
 public:
     enum class SceneError {
         ComponentDoesNotExistError
     };
 
-    Scene() : mEntityCounter{ 0 }, mComponents{}, mEntities{}, mSystems{} {}
+    Scene() : mEntityCounter{ 0 }, mComponents{}, mEntities{}, mSystems{}, mSystemNames{} {}
 
     Entity newEntity();
 
@@ -114,6 +118,7 @@ public:
     template <typename T>
     void registerSystem() {
         mSystems.push_back(std::make_shared<T>());
+        mSystemNames.push_back(Profiler::intern(Profiler::demangle(typeid(T).name())));
     }
 
     void setupSystems(Game& game);
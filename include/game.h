@@ -4,10 +4,16 @@
 #include <camera.h>
 #include <ecs.h>
 #include <input.h>
+#include <snapshot.h>
+#include <renderer.h>
+#include <renderthread.h>
+#include <profiler.h>
+#include <stats.h>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdlib>
 #include <string>
 
 namespace BEG {
@@ -23,6 +29,20 @@ private:
 
     float mPrevTime{}, mDeltaTime{};
 
+    unsigned long mFrame{};
+    TripleBuffer<FrameSnapshot> mSnapshots{};
+    Renderer mRenderer{};
+
+    FrameStats mStats{};
+    std::string mStatsPath{};
+
+    /* F12 writes the last frames to trace-<frame>.json while the game runs, in BEG_PROFILE builds */
+    static constexpr Keyboard::Key TraceKey{ Keyboard::Key::F12 };
+    static constexpr size_t TraceKeyFrames{ 300 };
+    bool mTraceKeyDown{};
+
+    RenderThread mRenderThread{ mRenderer, mSnapshots, mStats };
+
     void framebufferSizeHandler(int width, int height);
 public:
     enum class GameError {
@@ -32,6 +52,8 @@ public:
 
     Scene scene{};
     Camera camera{};
+    /* where game.camera draws in the window as left, bottom, width, height fractions, zero width hides it */
+    Vector<4> viewport{ 0.0f, 0.0f, 1.0f, 1.0f };
 
     Game(const std::string& name, int width, int height);
     ~Game();
@@ -57,6 +79,16 @@ public:
 
     float deltaTime() const;
 
+    /* the snapshot being written by the simulation this frame */
+    FrameSnapshot& snapshot();
+
+    /* rolling frame and per-phase timings */
+    FrameStats& frameStats();
+    const FrameStats& frameStats() const;
+
+    /* write a frame time summary when the game exits, CSV if the path ends in .csv and JSON otherwise */
+    void statsOnExit(const std::string& path);
+
     void begin();
 };
 
@@ -0,0 +1,275 @@
+#ifndef BEG_GEOMETRY_H
+#define BEG_GEOMETRY_H
+
+#include <bmath.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace BEG {
+
+struct AABB;
+struct Sphere;
+
+/*
+ * Bounds stored component-wise, one array per field and all of equal length,
+ * so the batch tests below can check a whole chunk per instruction group.
+ * Boxes are kept as center and half extents, which is what both the plane
+ * and slab tests want.
+ */
+struct AABBSoA {
+    std::span<const float> centerX{}, centerY{}, centerZ{};
+    std::span<const float> extentX{}, extentY{}, extentZ{};
+};
+
+struct SphereSoA {
+    std::span<const float> x{}, y{}, z{}, radius{};
+};
+
+/*
+ * The batch tests write one bit per element, bit i % 64 of word i / 64, and
+ * need at least maskWords(count) words. Trailing bits of the last word are
+ * cleared. They run 8 wide on AVX and 4 wide on SSE/NEON, and give the same
+ * answer as the scalar member functions for every element.
+ */
+enum class GeometryError {
+    SizeMismatchError
+};
+
+constexpr size_t maskWords(size_t count) { return (count + 63) / 64; }
+
+constexpr bool testMask(std::span<const std::uint64_t> mask, size_t i) {
+    return ((mask[i / 64] >> (i % 64)) & 1u) != 0;
+}
+
+/* the points p with dot(normal, p) + distance == 0, normal pointing to the positive side */
+struct Plane {
+    Vector<3> normal{ 0.0f, 1.0f, 0.0f };
+    Number distance{ 0.0f };
+
+    static constexpr Plane fromPointNormal(const Vector<3>& point, const Vector<3>& normal) {
+        return { normal, -normal.dot(point) };
+    }
+
+    /* counter-clockwise a, b, c faces the positive side */
+    static Plane fromPoints(const Vector<3>& a, const Vector<3>& b, const Vector<3>& c);
+
+    constexpr Number signedDistance(const Vector<3>& point) const {
+        return normal.dot(point) + distance;
+    }
+
+    /* scaled so the normal is unit length and signedDistance is a true distance */
+    Plane normalized() const;
+
+    /* the plane under an affine transform, through the inverse transpose so non-uniform scale is handled */
+    Plane transformed(const Matrix<4>& matrix) const;
+};
+
+struct Sphere {
+    Vector<3> center{ 0.0f, 0.0f, 0.0f };
+    Number radius{ 0.0f };
+
+    constexpr bool contains(const Vector<3>& point) const {
+        Vector<3> offset{ point - center };
+        return offset.dot(offset) <= radius * radius;
+    }
+
+    constexpr bool intersects(const Sphere& other) const {
+        Vector<3> offset{ other.center - center };
+        Number reach{ radius + other.radius };
+        return offset.dot(offset) <= reach * reach;
+    }
+
+    /* smallest sphere holding both */
+    Sphere merged(const Sphere& other) const;
+
+    /* the radius grows by the largest axis scale, so the result always holds the transformed sphere */
+    Sphere transformed(const Matrix<4>& matrix) const;
+
+    AABB bounds() const;
+};
+
+struct AABB {
+    Vector<3> min{ 0.0f, 0.0f, 0.0f };
+    Vector<3> max{ 0.0f, 0.0f, 0.0f };
+
+    /* inverted so that merging anything into it gives that thing back */
+    static constexpr AABB empty() {
+        constexpr Number inf{ std::numeric_limits<Number>::infinity() };
+        return { { inf, inf, inf }, { -inf, -inf, -inf } };
+    }
+
+    static constexpr AABB fromCenterExtents(const Vector<3>& center, const Vector<3>& extents) {
+        return { center - extents, center + extents };
+    }
+
+    static constexpr AABB fromPoints(std::span<const Vector<3>> points) {
+        AABB result{ empty() };
+
+        for (const Vector<3>& point : points) {
+            result.merge(point);
+        }
+
+        return result;
+    }
+
+    constexpr bool isEmpty() const {
+        return min.x() > max.x() || min.y() > max.y() || min.z() > max.z();
+    }
+
+    constexpr Vector<3> center() const { return (min + max) * 0.5f; }
+    constexpr Vector<3> extents() const { return (max - min) * 0.5f; }
+
+    constexpr AABB& merge(const Vector<3>& point) {
+        for (size_t i{ 0 }; i < 3; ++i) {
+            min[i] = point[i] < min[i] ? point[i] : min[i];
+            max[i] = point[i] > max[i] ? point[i] : max[i];
+        }
+
+        return *this;
+    }
+
+    constexpr AABB& merge(const AABB& other) {
+        for (size_t i{ 0 }; i < 3; ++i) {
+            min[i] = other.min[i] < min[i] ? other.min[i] : min[i];
+            max[i] = other.max[i] > max[i] ? other.max[i] : max[i];
+        }
+
+        return *this;
+    }
+
+    constexpr AABB merged(const AABB& other) const {
+        AABB result{ *this };
+        return result.merge(other);
+    }
+
+    constexpr bool contains(const Vector<3>& point) const {
+        return point.x() >= min.x() && point.x() <= max.x()
+            && point.y() >= min.y() && point.y() <= max.y()
+            && point.z() >= min.z() && point.z() <= max.z();
+    }
+
+    constexpr bool intersects(const AABB& other) const {
+        return min.x() <= other.max.x() && max.x() >= other.min.x()
+            && min.y() <= other.max.y() && max.y() >= other.min.y()
+            && min.z() <= other.max.z() && max.z() >= other.min.z();
+    }
+
+    /* tight box around the transformed box: the extents go through the absolute 3x3 block */
+    constexpr AABB transformed(const Matrix<4>& matrix) const {
+        Vector<3> c{ center() }, e{ extents() };
+        Vector<3> resultCenter{}, resultExtents{};
+
+        for (size_t r{ 0 }; r < 3; ++r) {
+            Number sum{ 0.0f }, reach{ 0.0f };
+
+            for (size_t k{ 0 }; k < 3; ++k) {
+                Number m{ matrix.at(r, k) };
+                sum += m * c[k];
+                reach += (m < 0.0f ? -m : m) * e[k];
+            }
+
+            resultCenter[r] = sum + matrix.at(r, 3);
+            resultExtents[r] = reach;
+        }
+
+        return fromCenterExtents(resultCenter, resultExtents);
+    }
+
+    Sphere boundingSphere() const;
+};
+
+struct Ray {
+    Vector<3> origin{ 0.0f, 0.0f, 0.0f };
+    Vector<3> direction{ 0.0f, 0.0f, -1.0f };
+
+    constexpr Vector<3> at(Number t) const {
+        return origin + (direction * t);
+    }
+
+    constexpr Ray transformed(const Matrix<4>& matrix) const {
+        return {
+            Vector<3>(matrix * Vector<4>(origin, 1.0f)),
+            Vector<3>(matrix * Vector<4>(direction, 0.0f))
+        };
+    }
+
+    /*
+     * Distance along the ray to the first hit in [0, maxDistance], 0 when the
+     * origin starts inside. Axis-parallel rays are fine, the slab test leans
+     * on the infinities from dividing by a zero component.
+     */
+    std::optional<Number> intersect(const AABB& box, Number maxDistance = std::numeric_limits<Number>::infinity()) const;
+    std::optional<Number> intersect(const Sphere& sphere, Number maxDistance = std::numeric_limits<Number>::infinity()) const;
+    std::optional<Number> intersect(const Plane& plane, Number maxDistance = std::numeric_limits<Number>::infinity()) const;
+
+    /* the slab test over a whole array of boxes, bit set where intersect(AABB::fromCenterExtents(...)) would hit */
+    void test(const AABBSoA& boxes, std::span<std::uint64_t> hits, Number maxDistance = std::numeric_limits<Number>::infinity()) const;
+};
+
+/*
+ * Six inward-facing, normalized planes. Tests are conservative: something
+ * reported outside is outside, but a box near a corner can be reported
+ * inside while missing the view.
+ */
+struct Frustum {
+    enum Side : size_t { Left, Right, Bottom, Top, Near, Far, Count };
+
+    /* the clip space depth range a projection maps the near and far planes to */
+    enum class ClipDepth {
+        NegativeOneToOne, /* OpenGL's default, near at -w and far at w */
+        ZeroToOne,        /* glClipControl's GL_ZERO_TO_ONE, near at 0 */
+        ReversedZeroToOne /* GL_ZERO_TO_ONE with near at w and far at 0, as reverse-Z projections use */
+    };
+
+    std::array<Plane, Side::Count> planes{};
+
+    /* an infinite far plane has no normal and is kept as one that everything is in front of */
+    static Frustum fromMatrix(const Matrix<4>& viewProjection, ClipDepth depth = ClipDepth::NegativeOneToOne);
+
+    constexpr bool contains(const Vector<3>& point) const {
+        for (const Plane& plane : planes) {
+            if (plane.signedDistance(point) < 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    constexpr bool intersects(const Sphere& sphere) const {
+        for (const Plane& plane : planes) {
+            if (plane.signedDistance(sphere.center) < -sphere.radius)
+                return false;
+        }
+
+        return true;
+    }
+
+    constexpr bool intersects(const AABB& box) const {
+        return intersects(box.center(), box.extents());
+    }
+
+    /* a box given as center and half extents, the form the batch test reads */
+    constexpr bool intersects(const Vector<3>& center, const Vector<3>& extents) const {
+        for (const Plane& plane : planes) {
+            const Vector<3>& n{ plane.normal };
+            Vector<3> absolute{ n.x() < 0.0f ? -n.x() : n.x(), n.y() < 0.0f ? -n.y() : n.y(), n.z() < 0.0f ? -n.z() : n.z() };
+
+            if (plane.signedDistance(center) + absolute.dot(extents) < 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    /* bit set where the matching intersects() would return true, boxes as in intersects(center, extents) */
+    void test(const AABBSoA& boxes, std::span<std::uint64_t> visible) const;
+    void test(const SphereSoA& spheres, std::span<std::uint64_t> visible) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BEG_GPU_H
+#define BEG_GPU_H
+
+#include <bmath.h>
+
+#include <span>
+#include <type_traits>
+
+namespace BEG {
+
+/*
+ * Mirrors of the bmath types laid out the way GLSL std140 and std430 blocks
+ * lay them out: vec3 padded to 16 bytes, matrices column-major with every
+ * column 16 byte aligned. A struct built from these (and plain floats/ints in
+ * the usual order) can be memcpy'd into a UBO or SSBO, or written straight
+ * into a mapped buffer, and uploaded as uniforms with transpose = GL_FALSE.
+ *
+ * std140 packs a scalar into the 4 bytes after a vec3; Vec3 keeps them as
+ * `pad`, so a following float must be placed there by hand to match.
+ */
+namespace GPU {
+    enum class GPUError {
+        SizeMismatchError
+    };
+
+    struct alignas(8) Vec2 {
+        float x{}, y{};
+
+        Vec2() = default;
+        Vec2(const Vector<2>& v) : x{ v.x() }, y{ v.y() } {}
+    };
+
+    struct alignas(16) Vec3 {
+        float x{}, y{}, z{};
+        float pad{};
+
+        Vec3() = default;
+        Vec3(const Vector<3>& v) : x{ v.x() }, y{ v.y() }, z{ v.z() } {}
+    };
+
+    struct alignas(16) Vec4 {
+        float x{}, y{}, z{}, w{};
+
+        Vec4() = default;
+        Vec4(const Vector<4>& v) { SIMD::store(&x, SIMD::load(v.data().data())); }
+    };
+
+    /* three columns, each padded to a vec4 */
+    struct alignas(16) Mat3 {
+        float columns[3][4]{};
+
+        Mat3() = default;
+        Mat3(const Matrix<3>& m) {
+            for (size_t c{ 0 }; c < 3; ++c) {
+                for (size_t r{ 0 }; r < 3; ++r) {
+                    columns[c][r] = m.at(r, c);
+                }
+            }
+        }
+    };
+
+    struct alignas(16) Mat4 {
+        float columns[4][4]{};
+
+        Mat4() = default;
+        /* the row-major Matrix transposed in registers */
+        Mat4(const Matrix<4>& m) { SIMD::transposeMatrix4(m.data().data(), &columns[0][0]); }
+
+        const float* data() const { return &columns[0][0]; }
+    };
+
+    static_assert(sizeof(Vec2) == 8 && alignof(Vec2) == 8);
+    static_assert(sizeof(Vec3) == 16 && alignof(Vec3) == 16);
+    static_assert(sizeof(Vec4) == 16 && alignof(Vec4) == 16);
+    static_assert(sizeof(Mat3) == 48 && alignof(Mat3) == 16);
+    static_assert(sizeof(Mat4) == 64 && alignof(Mat4) == 16);
+    static_assert(std::is_trivially_copyable_v<Mat4> && std::is_trivially_copyable_v<Vec3>, "GPU types are copied as raw bytes");
+
+    /* whole arrays, 4 elements per step where SIMD is available; the spans must be the same length */
+    void convert(std::span<const Vector<3>> in, std::span<Vec3> out);
+    void convert(std::span<const Vector<4>> in, std::span<Vec4> out);
+    void convert(std::span<const Matrix<4>> in, std::span<Mat4> out);
+}
+
+}
+
+#endif
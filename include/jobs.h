@@ -0,0 +1,63 @@
+#ifndef BEG_JOBS_H
+#define BEG_JOBS_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BEG {
+
+/*
+ * A fixed set of worker threads for splitting one data-parallel loop at a time.
+ * The calling thread works on the loop too and returns once every chunk has
+ * run, so the pool never outlives the data it was handed.
+ */
+class JobPool {
+private:
+    std::vector<std::thread> mWorkers{};
+
+    /* serialises parallelFor callers, only one loop is shared out at a time */
+    std::mutex mSubmitMutex{};
+
+    std::mutex mMutex{};
+    std::condition_variable mWake{};
+    std::condition_variable mIdle{};
+
+    /* the loop being shared out, only changed under mMutex while no worker is inside it */
+    const std::function<void(size_t, size_t)>* mTask{ nullptr };
+    size_t mCount{};
+    size_t mGrain{};
+    size_t mNext{};
+    size_t mBusy{};
+    std::uint64_t mGeneration{};
+    std::exception_ptr mError{};
+    bool mStopping{ false };
+
+    void work(size_t index);
+    /* claim and run chunks of the current loop until none are left */
+    void drain(std::unique_lock<std::mutex>& lock);
+public:
+    /* `threads` workers in addition to the caller, by default one per remaining hardware thread */
+    explicit JobPool(size_t threads = defaultThreads());
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    static size_t defaultThreads();
+    /* process-wide pool, started on first use */
+    static JobPool& shared();
+
+    size_t threads() const;
+
+    /* run fn(begin, end) over [0, count) in chunks of `grain`, rethrowing the first exception any chunk threw */
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+};
+
+}
+
+#endif
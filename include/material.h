@@ -0,0 +1,18 @@
+#ifndef BEG_MATERIAL_H
+#define BEG_MATERIAL_H
+
+#include <color.h>
+
+namespace BEG {
+
+struct Material {
+    Color ambient{ 1.0f, 1.0f, 1.0f };
+    Color diffuse{ 1.0f, 1.0f, 1.0f };
+    Color specular{ 1.0f, 1.0f, 1.0f };
+
+    float shininess{ 1.0f };
+};
+
+}
+
+#endif
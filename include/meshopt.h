@@ -0,0 +1,81 @@
+#ifndef BEG_MESHOPT_H
+#define BEG_MESHOPT_H
+
+#include <bmath.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace BEG {
+
+/*
+ * Load-time reordering of indexed triangle lists, in the order they are
+ * meant to run: triangles for the post-transform vertex cache (Tipsify,
+ * Sander et al. 2007), then clusters of them for overdraw, then vertices in
+ * the order the triangles first fetch them. Each step keeps every triangle
+ * and its winding, only the order changes.
+ *
+ * Cache figures come from a FIFO cache simulation. ACMR is vertices shaded
+ * per triangle (0.5 is the limit on large regular meshes, 3 is no reuse),
+ * ATVR is vertices shaded per vertex referenced (1 is ideal).
+ */
+namespace MeshOptimizer {
+    enum class MeshOptimizerError {
+        IncompleteTriangleError,
+        IndexOutOfRangeError,
+        SizeMismatchError
+    };
+
+    /* a conservative stand-in for the post-transform cache of current GPUs */
+    inline constexpr size_t DefaultCacheSize{ 16 };
+
+    struct CacheStats {
+        size_t transformed{}; /* cache misses, i.e. vertex shader invocations */
+        double acmr{}, atvr{};
+    };
+
+    struct Report {
+        CacheStats before{}, after{};
+    };
+
+    CacheStats analyzeVertexCache(std::span<const unsigned int> indices, size_t vertexCount, size_t cacheSize = DefaultCacheSize);
+
+    /* Tipsify: fans out from a vertex while its neighbours are likely still cached, linear in the triangle count */
+    std::vector<unsigned int> optimizeVertexCache(std::span<const unsigned int> indices, size_t vertexCount, size_t cacheSize = DefaultCacheSize);
+
+    /*
+     * Cuts a cache-ordered list into clusters where the cache would be cold
+     * anyway, or where cutting costs less than `threshold` times the
+     * cluster's ACMR, then sorts the clusters so the ones facing away from
+     * the mesh center draw first and tend to occlude the rest.
+     */
+    std::vector<unsigned int> optimizeOverdraw(std::span<const unsigned int> indices, std::span<const Vector<3>> positions,
+                                               size_t cacheSize = DefaultCacheSize, float threshold = 1.05f);
+
+    /* renumbers `indices` in place by first use and returns each old vertex's new index, unused vertices go last */
+    std::vector<unsigned int> optimizeVertexFetch(std::span<unsigned int> indices, size_t vertexCount);
+
+    /* all three steps; apply `remap` to the vertex data with remapVertices() */
+    Report optimize(std::vector<unsigned int>& indices, std::span<const Vector<3>> positions, std::vector<unsigned int>& remap,
+                    size_t cacheSize = DefaultCacheSize, float threshold = 1.05f);
+
+    /* moves record i, `stride` elements long, to record remap[i] */
+    template <typename T>
+    void remapVertices(std::vector<T>& data, size_t stride, std::span<const unsigned int> remap) {
+        if (data.size() != remap.size() * stride)
+            throw MeshOptimizerError::SizeMismatchError;
+
+        std::vector<T> result(data.size());
+        for (size_t i{ 0 }; i < remap.size(); ++i) {
+            std::copy_n(data.begin() + static_cast<std::ptrdiff_t>(i * stride), stride, result.begin() + static_cast<std::ptrdiff_t>(remap[i] * stride));
+        }
+
+        data = std::move(result);
+    }
+}
+
+}
+
+#endif
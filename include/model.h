@@ -3,34 +3,102 @@
 
 #include <bmath.h>
 #include <color.h>
+#include <geometry.h>
+#include <gpu.h>
+#include <material.h>
+#include <meshopt.h>
 
 #include <glad/glad.h>
 
 #include <algorithm>
+#include <cstddef>
+#include <type_traits>
 #include <vector>
 
 namespace BEG {
 
+/*
+ * What varies between instances of one mesh, read by basic.vert as vertex
+ * attributes with a divisor of 1: the model matrix columns at locations 3 to
+ * 6, the material colors at 7 to 9, then shininess and lightable at 10.
+ */
+struct InstanceData {
+    GPU::Mat4 model{};
+    float ambient[3]{}, diffuse[3]{}, specular[3]{};
+    float shininess{}, lightable{};
+
+    InstanceData() = default;
+    InstanceData(const Matrix<4>& transform, const Material& material, bool isLightable);
+};
+
+static_assert(sizeof(InstanceData) == 112 && std::is_trivially_copyable_v<InstanceData>, "instances are uploaded as raw bytes");
+
+/* the GL names needed to draw a model, cheap to copy into render snapshots */
+struct Mesh {
+    /* vertex buffer binding points in every model's VAO */
+    static constexpr unsigned int VertexBinding{ 0 }, InstanceBinding{ 1 };
+
+    unsigned int vao{};
+    int count{}; /* indices */
+    unsigned int indexType{ GL_UNSIGNED_INT }; /* GL_UNSIGNED_SHORT when every index fits */
+
+    /* bind the VAO with `instanceBuffer` as its instance data, only needed when either changed */
+    void bind(unsigned int instanceBuffer) const;
+    /* `instances` InstanceData records starting at `first`, in one call, with this mesh bound */
+    void draw(unsigned int first, int instances) const;
+};
+
+/*
+ * Interleaved position, normal and color (9 floats per vertex) in one VBO,
+ * drawn through an element buffer so vertices shared between triangles are
+ * stored and transformed once.
+ */
 class Model {
 private:
-    /* packed array of vertices and vertex colors */
+    static constexpr size_t Stride{ 9 };
+
+    /* packed array of unique vertices and vertex colors */
     std::vector<float> mVertices{};
+    /* three per triangle, counter-clockwise */
+    std::vector<unsigned int> mIndices{};
 
-    unsigned int mVAO{}, mVBO{};
+    /* model space, computed once from the vertex positions */
+    AABB mBounds{};
+    Sphere mBoundingSphere{};
 
+    unsigned int mVAO{}, mVBO{}, mEBO{};
+
+    /* computes the bounds and creates the GL buffers from mVertices and mIndices */
+    void build();
+    /* (re)fills the GL buffers */
+    void upload();
+    /* hands the GL objects to the render thread for deletion and forgets them */
+    void release();
 public:
     enum class ModelError {
         VerticesIndicesMismatchError,
-        TooFewColorsError
+        VerticesNormalsMismatchError,
+        TooFewColorsError,
+        IndexOutOfRangeError,
+        IncompleteTriangleError
     };
 
     Model();
+    /* one entry per triangle corner, identical corners are merged into one vertex */
     Model(
         const std::vector<Vector<3>>& vertices,
         const std::vector<Vector<3>>& normals,
         const std::vector<int>& colorIndices,
         const std::vector<Color>& colors
     );
+    /* unique vertices and the triangles between them, used as given */
+    Model(
+        const std::vector<Vector<3>>& vertices,
+        const std::vector<Vector<3>>& normals,
+        const std::vector<int>& colorIndices,
+        const std::vector<Color>& colors,
+        const std::vector<unsigned int>& indices
+    );
     ~Model();
 
     Model& operator=(Model&& model);
@@ -38,7 +106,21 @@ public:
     static Model cube(const std::vector<int>& colorIndices, const std::vector<Color>& colors);
     static Model cube(const Color& color);
 
-    void render();
+    /*
+     * Reorder triangles and vertices for the vertex cache, overdraw and fetch
+     * locality (see MeshOptimizer) and re-upload them. Meant for load time,
+     * the figures in the report are before and after.
+     */
+    MeshOptimizer::Report optimize(size_t cacheSize = MeshOptimizer::DefaultCacheSize);
+
+    size_t vertexCount() const;
+    size_t indexCount() const;
+
+    Mesh mesh() const;
+
+    const AABB& bounds() const;
+    /* centered on the box, with the radius of the farthest vertex, so tighter than bounds().boundingSphere() */
+    const Sphere& boundingSphere() const;
 };
 
 }
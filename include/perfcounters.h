@@ -0,0 +1,53 @@
+#ifndef BEG_PERFCOUNTERS_H
+#define BEG_PERFCOUNTERS_H
+
+/*
+ * Hardware performance counters for the calling thread, read through
+ * perf_event_open on Linux. Every thread lazily opens its own counter group
+ * the first time it reads; elsewhere, or when the kernel refuses, nothing is
+ * available and every read returns zeros.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace BEG {
+
+class PerfCounters {
+private:
+    static std::atomic<bool> sEnabled;
+public:
+    enum class Counter {
+        Cycles,
+        Instructions,
+        L1DMisses,
+        LLCMisses,
+        BranchMisses,
+
+        Count
+    };
+
+    static constexpr size_t CounterCount{ static_cast<size_t>(Counter::Count) };
+
+    using Values = std::array<std::uint64_t, CounterCount>;
+
+    static const char* name(Counter counter);
+
+    static bool enabled() {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    static void enable(bool value);
+
+    /* whether the calling thread managed to open `counter` */
+    static bool available(Counter counter);
+
+    /* running totals for the calling thread since its counters were opened */
+    static Values read();
+};
+
+}
+
+#endif
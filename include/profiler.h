@@ -0,0 +1,102 @@
+#ifndef BEG_PROFILER_H
+#define BEG_PROFILER_H
+
+/*
+ * Scoped CPU timers written into per-thread lock-free rings and exported in the
+ * Chrome Trace Event format (chrome://tracing, Perfetto). Scopes, thread names,
+ * frame marks and dumps go through the BEG_PROFILE_* macros, which only exist
+ * when built with BEG_PROFILE (meson -Dprofile=true) and compile to nothing
+ * otherwise; no ring is allocated and no lock is taken.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace BEG {
+
+class Profiler {
+private:
+    static std::atomic<bool> sEnabled;
+public:
+    /* number of frames whose events are kept around for a dump */
+    static constexpr size_t MaxFrames{ 1024 };
+    /* events kept per thread before the oldest are overwritten */
+    static constexpr size_t EventsPerThread{ 1 << 16 };
+
+    static bool enabled() {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    static void enable(bool value);
+
+    /* raw timestamp, converted to nanoseconds only when a trace is exported */
+    static std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    static double ticksToNanoseconds(std::uint64_t ticks);
+
+    /* copy a name into storage that lives as long as the program, for names built at runtime */
+    static const char* intern(const std::string& name);
+    static std::string demangle(const char* name);
+
+    /* label the calling thread in exported traces */
+    static void nameThread(const char* name);
+
+    static void record(const char* name, std::uint64_t start, std::uint64_t end);
+
+    /* mark the start of a new frame, writes any dump requested since the last one */
+    static void frame();
+
+    /* write the last `frames` frames at the next frame boundary */
+    static void requestDump(const std::string& path, size_t frames);
+    /* write the last `frames` frames right away, returns false if the file could not be written */
+    static bool dump(const std::string& path, size_t frames);
+};
+
+class ProfileScope {
+private:
+    const char* mName{};
+    std::uint64_t mStart{};
+public:
+    ProfileScope(const char* name) : mName{ name }, mStart{ Profiler::enabled() ? Profiler::now() : 0 } {}
+    ~ProfileScope() {
+        if (mStart != 0)
+            Profiler::record(mName, mStart, Profiler::now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+}
+
+#define BEG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define BEG_PROFILE_CONCAT(a, b) BEG_PROFILE_CONCAT_IMPL(a, b)
+
+/* the arguments are not evaluated without BEG_PROFILE, so they may do work (e.g. Profiler::intern) */
+#ifdef BEG_PROFILE
+/* time the rest of the enclosing scope, `name` must outlive the program (e.g. a string literal) */
+#define BEG_PROFILE_SCOPE(name) ::BEG::ProfileScope BEG_PROFILE_CONCAT(begProfileScope, __LINE__){ name }
+#define BEG_PROFILE_THREAD(name) ::BEG::Profiler::nameThread(name)
+#define BEG_PROFILE_FRAME() ::BEG::Profiler::frame()
+#define BEG_PROFILE_DUMP(path, frames) static_cast<void>(::BEG::Profiler::dump(path, frames))
+#else
+#define BEG_PROFILE_SCOPE(name) ((void)0)
+#define BEG_PROFILE_THREAD(name) ((void)0)
+#define BEG_PROFILE_FRAME() ((void)0)
+#define BEG_PROFILE_DUMP(path, frames) ((void)0)
+#endif
+
+#endif
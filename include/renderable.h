@@ -3,19 +3,18 @@
 
 #include <shader.h>
 #include <model.h>
+#include <material.h>
 #include <ecs.h>
 #include <game.h>
 #include <basic.h>
+#include <geometry.h>
+#include <renderqueue.h>
 
-namespace BEG {
-
-struct Material {
-    Color ambient{ 1.0f, 1.0f, 1.0f };
-    Color diffuse{ 1.0f, 1.0f, 1.0f };
-    Color specular{ 1.0f, 1.0f, 1.0f };
+#include <cstdint>
+#include <memory>
+#include <vector>
 
-    float shininess{ 1.0f };
-};
+namespace BEG {
 
 struct Light : Component {
     Color color{ 1.0f, 1.0f, 1.0f };
@@ -34,15 +33,94 @@ struct SpotLight : Light {
     float range{ 1.0f }, angle{ M_PIf32 / 2.0f }, blurAngle{ 0.0f };
 };
 
+/*
+ * World space box of an entity's model. It is only rebuilt when the Transform
+ * or the model's local box differ from the ones it was built from, so an
+ * entity that does not move costs a comparison per frame.
+ */
+class WorldBounds {
+private:
+    Position mCenter{ 0.0f, 0.0f, 0.0f };
+    Vector<3> mExtents{ 0.0f, 0.0f, 0.0f };
+
+    /* what the bounds were last built from */
+    Position mPosition{ 0.0f, 0.0f, 0.0f };
+    Quaternion mOrientation{};
+    Vector<3> mScale{ 0.0f, 0.0f, 0.0f };
+    AABB mLocal{};
+    bool mValid{ false };
+public:
+    /* true if the bounds had to be rebuilt */
+    bool update(const Transform& transform, const AABB& local);
+
+    /* the center keeps full position precision, see Camera::relative */
+    const Position& center() const;
+    const Vector<3>& extents() const;
+};
+
 struct Renderable : Component {
     Model model{};
     Material material{};
     Shader shader{};
 
     bool lightable{ true };
+    /* lower passes draw first, see RenderQueue */
+    unsigned int pass{ 0 };
+
+    /* kept up to date by RenderSystem */
+    WorldBounds bounds{};
 };
 
+/*
+ * A view drawn each frame besides game.camera's: split-screen, a minimap, a
+ * security camera rendering into a texture. The camera's aspect follows the
+ * viewport, which is given as fractions of the target so it tracks resizes.
+ */
+struct CameraView : Component {
+    Camera camera{};
+
+    Vector<4> viewport{ 0.0f, 0.0f, 1.0f, 1.0f }; /* left, bottom, width, height */
+    std::shared_ptr<RenderTarget> target{};     /* null draws into the window */
+
+    int order{ 1 }; /* views into the same target draw lowest first, game.camera is 0 */
+    bool active{ true };
+};
+
+/*
+ * Copies the render-relevant state of the scene into the game's frame
+ * snapshot, drawing happens once it is published.
+ *
+ * One pass over the entities refreshes their bounds and tests them against
+ * every view's frustum, leaving a visibility mask per view. Draws are then
+ * recorded once for entities seen by any view, and each view gets the list
+ * of indices it sees, sorted by RenderQueue key into instanced batches.
+ * Positions are relative to the main camera; each view's matrix carries the
+ * offset to its own camera.
+ */
 class RenderSystem : public System<Transform, Renderable> {
+private:
+    struct Source {
+        Camera* camera{};
+        Vector<4> viewport{};
+        std::shared_ptr<RenderTarget> target{};
+        int order{};
+    };
+
+    std::vector<Source> mSources{};
+    std::vector<Frustum> mFrusta{};
+
+    /* main camera relative bounds and the visibility masks, maskWords(count) words per view, reused so they only allocate while the scene grows */
+    std::vector<float> mCenterX{}, mCenterY{}, mCenterZ{};
+    std::vector<float> mExtentX{}, mExtentY{}, mExtentZ{};
+    std::vector<std::uint64_t> mVisible{};
+
+    /* the entity behind each recorded draw, and the sort buffers of the per-view render queues */
+    std::vector<std::uint32_t> mDrawEntities{};
+    std::vector<RenderQueue::Packet> mPackets{}, mScratch{};
+
+    /* the active views, offscreen ones first so the window's views can sample them in the same frame */
+    void collectViews(Game& game);
+
     void updateAll(Game& game, std::vector<std::tuple<Transform&, Renderable&>> view);
 };
 
@@ -0,0 +1,50 @@
+#ifndef BEG_RENDERER_H
+#define BEG_RENDERER_H
+
+#include <snapshot.h>
+#include <shader.h>
+#include <rendertarget.h>
+
+#include <glad/glad.h>
+
+#include <optional>
+#include <vector>
+
+namespace BEG {
+
+/*
+ * Submits frame snapshots to GL, must run on the thread that owns the GL
+ * context. Every view's instance data goes up in one buffer per frame, and
+ * each DrawBatch is one instanced draw; per-view uniforms are set once per
+ * shader, so draw calls scale with unique meshes rather than entities.
+ */
+class Renderer {
+private:
+    unsigned int mInstanceBuffer{};
+    /* every view's instances back to back in the order of their draw lists, and where each view's start */
+    std::vector<InstanceData> mInstances{};
+    std::vector<size_t> mViewBases{};
+
+    /* the window's views are drawn here when one of them is reverse-Z, for the float depth buffer */
+    RenderTarget mTarget{};
+
+    /* the depth state GL is currently in, only touched when a view asks for another */
+    std::optional<Camera::DepthMode> mDepthMode{};
+
+    void applyDepthMode(Camera::DepthMode mode);
+    /* the camera and lights of a view, on the program currently in use */
+    void setViewUniforms(const FrameSnapshot& frame, const ViewState& view, unsigned int shader);
+    void uploadInstances(const FrameSnapshot& frame);
+public:
+    Renderer() = default;
+    ~Renderer();
+
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    void draw(const FrameSnapshot& frame);
+};
+
+}
+
+#endif
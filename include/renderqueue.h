@@ -0,0 +1,51 @@
+#ifndef BEG_RENDERQUEUE_H
+#define BEG_RENDERQUEUE_H
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace BEG {
+
+/*
+ * Draw packets ordered by one 64-bit key, most significant field first:
+ *
+ *   63..60  pass    lower passes draw first
+ *   59..48  shader  GL program name
+ *   47..32  mesh    GL vertex array name
+ *   31..0   depth   view distance as float bits, front to back
+ *
+ * so sorting the keys groups draws by the state they need and orders each
+ * group front to back for early-Z. Names wider than their field wrap; that
+ * only splits batches, since batches are cut on the actual names.
+ */
+namespace RenderQueue {
+    struct Packet {
+        std::uint64_t key{};
+        std::uint32_t draw{}; /* index into FrameSnapshot::draws */
+    };
+
+    inline constexpr std::uint64_t PassBits{ 4 }, ShaderBits{ 12 }, MeshBits{ 16 }, DepthBits{ 32 };
+
+    constexpr std::uint64_t makeKey(unsigned int pass, unsigned int shader, unsigned int mesh, float depth) {
+        /* non-negative floats order like their bit patterns, NaN and anything behind the camera go first */
+        std::uint64_t depthBits{ std::bit_cast<std::uint32_t>(depth > 0.0f ? depth : 0.0f) };
+
+        return ((static_cast<std::uint64_t>(pass) & ((1u << PassBits) - 1)) << (ShaderBits + MeshBits + DepthBits))
+            | ((static_cast<std::uint64_t>(shader) & ((1u << ShaderBits) - 1)) << (MeshBits + DepthBits))
+            | ((static_cast<std::uint64_t>(mesh) & ((1u << MeshBits) - 1)) << DepthBits)
+            | depthBits;
+    }
+
+    /* the state part of a key, equal for packets that can share a batch */
+    constexpr std::uint64_t stateOf(std::uint64_t key) {
+        return key >> DepthBits;
+    }
+
+    /* stable LSD radix sort on the key, 8 bits per pass, skipping the bytes every key shares; `scratch` is reused storage */
+    void sort(std::vector<Packet>& packets, std::vector<Packet>& scratch);
+}
+
+}
+
+#endif
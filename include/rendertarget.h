@@ -0,0 +1,51 @@
+#ifndef BEG_RENDERTARGET_H
+#define BEG_RENDERTARGET_H
+
+#include <glad/glad.h>
+
+namespace BEG {
+
+/*
+ * An offscreen framebuffer with an RGBA8 color texture and a 32-bit float
+ * depth attachment. Views render into one to be sampled later (a minimap, a
+ * security camera), and reverse-Z frames use one because the default
+ * framebuffer only offers fixed-point depth, which throws away what reverse-Z
+ * gains. Can be made on any thread, the GL objects are created on first use
+ * on the GL thread; everything but width() and height() is GL thread only.
+ */
+class RenderTarget {
+private:
+    unsigned int mFramebuffer{}, mColor{}, mDepth{};
+    int mWidth{ 1 }, mHeight{ 1 };
+
+    void create();
+    void release();
+public:
+    enum class RenderTargetError {
+        IncompleteFramebufferError
+    };
+
+    RenderTarget() = default;
+    RenderTarget(int width, int height);
+    ~RenderTarget();
+
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+
+    int width() const;
+    int height() const;
+
+    /* (re)creates the attachments when the size changed, at least 1x1 */
+    void resize(int width, int height);
+
+    void bind();
+    /* copy the color attachment into the window's framebuffer and leave that bound */
+    void blitToScreen() const;
+
+    /* the GL texture holding the color attachment, 0 before the first bind() */
+    unsigned int colorTexture() const;
+};
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef BEG_RENDERTHREAD_H
+#define BEG_RENDERTHREAD_H
+
+#include <profiler.h>
+#include <renderer.h>
+#include <ring.h>
+#include <snapshot.h>
+#include <stats.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace BEG {
+
+struct RenderCommand {
+    enum class Type {
+        DrawFrame, /* draw the most recently published snapshot and swap */
+        Execute,   /* run a GL task, e.g. resource creation, and fulfil its future */
+        Stop
+    };
+
+    Type type{ Type::Stop };
+    std::packaged_task<void()>* task{ nullptr };
+};
+
+/*
+ * Owns the GL context while the game loop runs. The main thread only records
+ * snapshots and commands, the render thread turns them into GL calls and
+ * blocks in glfwSwapBuffers without stalling the simulation.
+ */
+class RenderThread {
+private:
+    static std::atomic<RenderThread*> sActive;
+
+    GLFWwindow* mWindow{};
+
+    Renderer& mRenderer;
+    TripleBuffer<FrameSnapshot>& mSnapshots;
+    FrameStats& mStats;
+
+    RingBuffer<RenderCommand, 256> mCommands{};
+    std::thread mThread{};
+
+    std::atomic<unsigned long> mFramesSubmitted{};
+    std::atomic<unsigned long> mFramesDrawn{};
+
+    /* GL cleanup tagged with the frame it was released in, run once that frame has been drawn */
+    std::mutex mGarbageMutex{};
+    std::vector<std::pair<unsigned long, std::function<void()>>> mGarbage{};
+
+    void run();
+    void collectGarbage(unsigned long drawnFrame);
+public:
+    RenderThread(Renderer& renderer, TripleBuffer<FrameSnapshot>& snapshots, FrameStats& stats)
+        : mWindow{ nullptr }, mRenderer{ renderer }, mSnapshots{ snapshots }, mStats{ stats } {}
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /* take the GL context away from the calling thread and hand it to the render thread */
+    void start(GLFWwindow* window);
+    /* drain the command ring, join and give the GL context back to the calling thread */
+    void stop();
+
+    bool running() const;
+
+    /* draw the snapshot that was just published */
+    void submitFrame();
+    /* block until every frame before `frame` has been drawn */
+    void waitForFrame(unsigned long frame);
+
+    /* run GL work on whichever thread owns the context and wait for it, rethrowing its exceptions */
+    static void execute(const std::function<void()>& work);
+    /* run GL cleanup once no frame in flight can still reference the released objects */
+    static void release(std::function<void()> work);
+};
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef BEG_RING_H
+#define BEG_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace BEG {
+
+/*
+ * Bounded lock-free ring for exactly one producer thread and one consumer thread.
+ * The blocking push() and pop() sleep on the opposite index with atomic wait
+ * instead of spinning when the ring is full or empty.
+ */
+template <typename T, size_t Capacity>
+class RingBuffer {
+private:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+    std::array<T, Capacity> mItems{};
+
+    /* kept on separate cache lines so the producer and consumer don't contend */
+    alignas(64) std::atomic<size_t> mHead{ 0 }; /* next item to pop */
+    alignas(64) std::atomic<size_t> mTail{ 0 }; /* next slot to push into */
+public:
+    RingBuffer() = default;
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    bool tryPush(const T& item) {
+        size_t tail{ mTail.load(std::memory_order_relaxed) };
+        if (tail - mHead.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        mItems[tail & (Capacity - 1)] = item;
+        mTail.store(tail + 1, std::memory_order_release);
+        mTail.notify_one();
+
+        return true;
+    }
+
+    void push(const T& item) {
+        while (!tryPush(item)) {
+            mHead.wait(mTail.load(std::memory_order_relaxed) - Capacity, std::memory_order_acquire);
+        }
+    }
+
+    bool tryPop(T& item) {
+        size_t head{ mHead.load(std::memory_order_relaxed) };
+        if (head == mTail.load(std::memory_order_acquire))
+            return false;
+
+        item = mItems[head & (Capacity - 1)];
+        mHead.store(head + 1, std::memory_order_release);
+        mHead.notify_one();
+
+        return true;
+    }
+
+    T pop() {
+        T item{};
+        while (!tryPop(item)) {
+            mTail.wait(mHead.load(std::memory_order_relaxed), std::memory_order_acquire);
+        }
+
+        return item;
+    }
+
+    size_t size() const {
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+};
+
+}
+
+#endif
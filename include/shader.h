@@ -2,6 +2,7 @@
 #define BEG_SHADER_H
 
 #include <bmath.h>
+#include <gpu.h>
 
 #include <glad/glad.h>
 
@@ -50,11 +51,12 @@ public:
 
     Shader& operator=(Shader&& shader);
 
+    /* set a uniform on an arbitrary program, used when only the program ID is at hand (e.g. from a render snapshot) */
     template <typename T>
-    void setUniform(const std::string& name, const T& value);
+    static void setUniform(unsigned int program, const std::string& name, const T& value);
 
     template <typename T>
-    void setArrayUniform(const std::string& name, const std::string& suffix, const size_t index, const T& value) {
+    static void setArrayUniform(unsigned int program, const std::string& name, const std::string& suffix, const size_t index, const T& value) {
         size_t maxSize{ name.size() + suffix.size() + 10 };
         char* buffer{ new char[maxSize] };
 
@@ -64,10 +66,24 @@ public:
             std::snprintf(buffer, maxSize, "%s[%ld]", name.c_str(), index);
         }
 
-        setUniform(buffer, value);
+        setUniform(program, buffer, value);
         delete[] buffer;
     }
 
+    static void use(unsigned int program);
+
+    unsigned int id() const;
+
+    template <typename T>
+    void setUniform(const std::string& name, const T& value) {
+        setUniform(mProgramId, name, value);
+    }
+
+    template <typename T>
+    void setArrayUniform(const std::string& name, const std::string& suffix, const size_t index, const T& value) {
+        setArrayUniform(mProgramId, name, suffix, index, value);
+    }
+
     void use();
 };
 
@@ -0,0 +1,331 @@
+#ifndef BEG_SIMD_H
+#define BEG_SIMD_H
+
+/*
+ * Thin wrapper around the target's 4-wide float registers, chosen at compile time:
+ * SSE on x86, NEON on ARM, nothing otherwise (or when BEG_NO_SIMD is defined).
+ * Only plain IEEE add/sub/mul/div are used, never fused multiply-add or
+ * reciprocal estimates, so every lane rounds exactly like the scalar code as
+ * long as the compiler doesn't contract a*b+c on its own (-ffp-contract=off).
+ */
+
+#if !defined(BEG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define BEG_SIMD_SSE 1
+#include <immintrin.h>
+#elif !defined(BEG_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define BEG_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(BEG_SIMD_SSE) && defined(__AVX__)
+#define BEG_SIMD_AVX 1
+#endif
+
+#if !defined(BEG_SIMD_SSE) && !defined(BEG_SIMD_NEON)
+#include <cmath>
+#endif
+
+namespace BEG {
+
+namespace SIMD {
+
+#if defined(BEG_SIMD_SSE)
+
+inline constexpr bool Enabled{ true };
+
+using Float4 = __m128;
+
+inline Float4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline Float4 splat(float value) { return _mm_set1_ps(value); }
+inline Float4 zero() { return _mm_setzero_ps(); }
+
+inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+
+/* flip the sign of the lanes whose mask lane is -0.0f, exact like scalar negation */
+inline Float4 flipSigns(Float4 v, Float4 mask) { return _mm_xor_ps(v, mask); }
+
+inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+
+/* comparisons give all-ones lanes where true; bits() packs lane k's result into bit k */
+inline Float4 less(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Float4 lessEqual(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+inline Float4 maskAnd(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+inline Float4 maskOr(Float4 a, Float4 b) { return _mm_or_ps(a, b); }
+inline unsigned bits(Float4 mask) { return static_cast<unsigned>(_mm_movemask_ps(mask)); }
+
+template <int I>
+inline float lane(Float4 v) {
+    if constexpr (I == 0)
+        return _mm_cvtss_f32(v);
+    else
+        return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I)));
+}
+
+/* result lane k = v[Ik] */
+template <int I0, int I1, int I2, int I3>
+inline Float4 shuffle(Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I3, I2, I1, I0)); }
+
+inline void transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+
+/* four packed xyz triples to one register per component and back */
+inline void loadInterleaved3(const float* p, Float4& x, Float4& y, Float4& z) {
+    Float4 a{ _mm_loadu_ps(p) }, b{ _mm_loadu_ps(p + 4) }, c{ _mm_loadu_ps(p + 8) };
+
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+inline void storeInterleaved3(float* p, Float4 x, Float4 y, Float4 z) {
+    _mm_storeu_ps(p, _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+#elif defined(BEG_SIMD_NEON)
+
+inline constexpr bool Enabled{ true };
+
+using Float4 = float32x4_t;
+
+inline Float4 load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 set(float x, float y, float z, float w) { float v[4]{ x, y, z, w }; return vld1q_f32(v); }
+inline Float4 splat(float value) { return vdupq_n_f32(value); }
+inline Float4 zero() { return vdupq_n_f32(0.0f); }
+
+inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 div(Float4 a, Float4 b) {
+#if defined(__aarch64__)
+    return vdivq_f32(a, b);
+#else
+    float x[4], y[4];
+    vst1q_f32(x, a);
+    vst1q_f32(y, b);
+    return set(x[0] / y[0], x[1] / y[1], x[2] / y[2], x[3] / y[3]);
+#endif
+}
+
+inline Float4 flipSigns(Float4 v, Float4 mask) {
+    return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), vreinterpretq_u32_f32(mask)));
+}
+
+inline Float4 min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+
+inline Float4 less(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline Float4 lessEqual(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+inline Float4 maskAnd(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline Float4 maskOr(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline unsigned bits(Float4 mask) {
+    uint32x4_t top{ vshrq_n_u32(vreinterpretq_u32_f32(mask), 31) };
+    return vgetq_lane_u32(top, 0) | (vgetq_lane_u32(top, 1) << 1) | (vgetq_lane_u32(top, 2) << 2) | (vgetq_lane_u32(top, 3) << 3);
+}
+
+template <int I>
+inline float lane(Float4 v) { return vgetq_lane_f32(v, I); }
+
+template <int I0, int I1, int I2, int I3>
+inline Float4 shuffle(Float4 v) { return set(lane<I0>(v), lane<I1>(v), lane<I2>(v), lane<I3>(v)); }
+
+inline void transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) {
+    float32x4x2_t a{ vtrnq_f32(r0, r1) };
+    float32x4x2_t b{ vtrnq_f32(r2, r3) };
+
+    r0 = vcombine_f32(vget_low_f32(a.val[0]), vget_low_f32(b.val[0]));
+    r1 = vcombine_f32(vget_low_f32(a.val[1]), vget_low_f32(b.val[1]));
+    r2 = vcombine_f32(vget_high_f32(a.val[0]), vget_high_f32(b.val[0]));
+    r3 = vcombine_f32(vget_high_f32(a.val[1]), vget_high_f32(b.val[1]));
+}
+
+inline void loadInterleaved3(const float* p, Float4& x, Float4& y, Float4& z) {
+    float32x4x3_t v{ vld3q_f32(p) };
+    x = v.val[0];
+    y = v.val[1];
+    z = v.val[2];
+}
+
+inline void storeInterleaved3(float* p, Float4 x, Float4 y, Float4 z) {
+    vst3q_f32(p, float32x4x3_t{ { x, y, z } });
+}
+
+#else
+
+inline constexpr bool Enabled{ false };
+
+/* scalar stand-in so the kernels below still compile, bmath never selects them */
+struct Float4 {
+    float v[4];
+};
+
+inline Float4 load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+inline void store(float* p, Float4 v) { for (int i{ 0 }; i < 4; ++i) p[i] = v.v[i]; }
+inline Float4 set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+inline Float4 splat(float value) { return { { value, value, value, value } }; }
+inline Float4 zero() { return splat(0.0f); }
+
+inline Float4 add(Float4 a, Float4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+inline Float4 sub(Float4 a, Float4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+inline Float4 mul(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+inline Float4 div(Float4 a, Float4 b) { return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+
+inline Float4 flipSigns(Float4 v, Float4 mask) {
+    for (int i{ 0 }; i < 4; ++i) {
+        if (std::signbit(mask.v[i]))
+            v.v[i] = -v.v[i];
+    }
+    return v;
+}
+
+/* min/max pick the second operand on NaN like minps/maxps; masks are 1.0f / 0.0f lanes here, only ever read back through bits() */
+inline Float4 min(Float4 a, Float4 b) { for (int i{ 0 }; i < 4; ++i) a.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return a; }
+inline Float4 max(Float4 a, Float4 b) { for (int i{ 0 }; i < 4; ++i) a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return a; }
+
+inline Float4 less(Float4 a, Float4 b) { for (int i{ 0 }; i < 4; ++i) a.v[i] = a.v[i] < b.v[i] ? 1.0f : 0.0f; return a; }
+inline Float4 lessEqual(Float4 a, Float4 b) { for (int i{ 0 }; i < 4; ++i) a.v[i] = a.v[i] <= b.v[i] ? 1.0f : 0.0f; return a; }
+inline Float4 maskAnd(Float4 a, Float4 b) { for (int i{ 0 }; i < 4; ++i) a.v[i] = (a.v[i] != 0.0f && b.v[i] != 0.0f) ? 1.0f : 0.0f; return a; }
+inline Float4 maskOr(Float4 a, Float4 b) { for (int i{ 0 }; i < 4; ++i) a.v[i] = (a.v[i] != 0.0f || b.v[i] != 0.0f) ? 1.0f : 0.0f; return a; }
+inline unsigned bits(Float4 mask) {
+    unsigned result{ 0 };
+    for (unsigned i{ 0 }; i < 4; ++i) {
+        if (mask.v[i] != 0.0f)
+            result |= 1u << i;
+    }
+    return result;
+}
+
+template <int I>
+inline float lane(Float4 v) { return v.v[I]; }
+
+template <int I0, int I1, int I2, int I3>
+inline Float4 shuffle(Float4 v) { return { { v.v[I0], v.v[I1], v.v[I2], v.v[I3] } }; }
+
+inline void transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) {
+    Float4 t0{ { r0.v[0], r1.v[0], r2.v[0], r3.v[0] } };
+    Float4 t1{ { r0.v[1], r1.v[1], r2.v[1], r3.v[1] } };
+    Float4 t2{ { r0.v[2], r1.v[2], r2.v[2], r3.v[2] } };
+    Float4 t3{ { r0.v[3], r1.v[3], r2.v[3], r3.v[3] } };
+    r0 = t0; r1 = t1; r2 = t2; r3 = t3;
+}
+
+inline void loadInterleaved3(const float* p, Float4& x, Float4& y, Float4& z) {
+    x = set(p[0], p[3], p[6], p[9]);
+    y = set(p[1], p[4], p[7], p[10]);
+    z = set(p[2], p[5], p[8], p[11]);
+}
+
+inline void storeInterleaved3(float* p, Float4 x, Float4 y, Float4 z) {
+    for (int i{ 0 }; i < 4; ++i) {
+        p[i * 3] = x.v[i];
+        p[(i * 3) + 1] = y.v[i];
+        p[(i * 3) + 2] = z.v[i];
+    }
+}
+
+#endif
+
+/*
+ * Kernels for the 4-wide bmath types. Every output element accumulates its
+ * products in the same order as the generic loops, starting from zero, so the
+ * results are bit-identical to them.
+ */
+
+/* sum of the lanes of a * b, added left to right */
+inline float dot4(const float* a, const float* b) {
+    Float4 p{ mul(load(a), load(b)) };
+    return (((0.0f + lane<0>(p)) + lane<1>(p)) + lane<2>(p)) + lane<3>(p);
+}
+
+/* out = a * b for row-major 4x4 matrices, out may alias neither input */
+inline void multiplyMatrix4(const float* a, const float* b, float* out) {
+#if defined(BEG_SIMD_AVX)
+    /* two rows of the result per iteration, each half of the register is one row */
+    __m256 b0{ _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b)) };
+    __m256 b1{ _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4)) };
+    __m256 b2{ _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8)) };
+    __m256 b3{ _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12)) };
+
+    for (int r{ 0 }; r < 4; r += 2) {
+        const float* r0{ a + (r * 4) };
+        const float* r1{ r0 + 4 };
+
+        auto pair{ [](float x, float y) {
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(x)), _mm_set1_ps(y), 1);
+        } };
+
+        __m256 acc{ _mm256_setzero_ps() };
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(pair(r0[0], r1[0]), b0));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(pair(r0[1], r1[1]), b1));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(pair(r0[2], r1[2]), b2));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(pair(r0[3], r1[3]), b3));
+
+        _mm256_storeu_ps(out + (r * 4), acc);
+    }
+#else
+    Float4 b0{ load(b) }, b1{ load(b + 4) }, b2{ load(b + 8) }, b3{ load(b + 12) };
+
+    for (int r{ 0 }; r < 4; ++r) {
+        const float* row{ a + (r * 4) };
+
+        Float4 acc{ zero() };
+        acc = add(acc, mul(splat(row[0]), b0));
+        acc = add(acc, mul(splat(row[1]), b1));
+        acc = add(acc, mul(splat(row[2]), b2));
+        acc = add(acc, mul(splat(row[3]), b3));
+
+        store(out + (r * 4), acc);
+    }
+#endif
+}
+
+/* out = m * v for a row-major 4x4 matrix */
+inline void transformVector4(const float* m, const float* v, float* out) {
+    Float4 c0{ load(m) }, c1{ load(m + 4) }, c2{ load(m + 8) }, c3{ load(m + 12) };
+    transpose(c0, c1, c2, c3);
+
+    Float4 acc{ zero() };
+    acc = add(acc, mul(c0, splat(v[0])));
+    acc = add(acc, mul(c1, splat(v[1])));
+    acc = add(acc, mul(c2, splat(v[2])));
+    acc = add(acc, mul(c3, splat(v[3])));
+
+    store(out, acc);
+}
+
+inline void transposeMatrix4(const float* m, float* out) {
+    Float4 r0{ load(m) }, r1{ load(m + 4) }, r2{ load(m + 8) }, r3{ load(m + 12) };
+    transpose(r0, r1, r2, r3);
+
+    store(out, r0);
+    store(out + 4, r1);
+    store(out + 8, r2);
+    store(out + 12, r3);
+}
+
+/* Hamilton product of two (w, x, y, z) quaternions, lane k adds its four terms in the scalar order */
+inline Float4 multiplyQuaternion(Float4 a, Float4 b) {
+    const Float4 signs1{ set(-0.0f, 0.0f, -0.0f, 0.0f) };
+    const Float4 signs2{ set(-0.0f, 0.0f, 0.0f, -0.0f) };
+    const Float4 signs3{ set(-0.0f, -0.0f, 0.0f, 0.0f) };
+
+    Float4 t0{ mul(shuffle<0, 1, 0, 0>(a), shuffle<0, 0, 2, 3>(b)) };
+    Float4 t1{ mul(shuffle<1, 0, 1, 1>(a), shuffle<1, 1, 3, 2>(b)) };
+    Float4 t2{ mul(shuffle<2, 2, 2, 2>(a), shuffle<2, 3, 0, 1>(b)) };
+    Float4 t3{ mul(shuffle<3, 3, 3, 3>(a), shuffle<3, 2, 1, 0>(b)) };
+
+    return add(add(add(t0, flipSigns(t1, signs1)), flipSigns(t2, signs2)), flipSigns(t3, signs3));
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef BEG_SNAPSHOT_H
+#define BEG_SNAPSHOT_H
+
+/*
+ * Render-relevant scene state, copied out of the components once per frame so
+ * that the simulation can write frame N+1 while frame N is being drawn
+ */
+
+#include <bmath.h>
+#include <camera.h>
+#include <gpu.h>
+#include <material.h>
+#include <model.h>
+#include <rendertarget.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace BEG {
+
+/* instance data is stored in GPU layout, converted once on the simulation side so the render thread uploads it as it is */
+struct DrawItem {
+    InstanceData instance{};
+    Mesh mesh{};
+    unsigned int shader{}; /* GL shader program ID */
+};
+
+/* a run of a view's draw list sharing mesh and shader, drawn as one instanced call */
+struct DrawBatch {
+    Mesh mesh{};
+    unsigned int shader{};
+    std::uint32_t first{}, count{}; /* into ViewState::draws */
+};
+
+struct DirectionalLightState {
+    Vector<3> direction{}; /* normalized, pointing towards the light */
+    Vector<3> color{};
+    float ambientStrength{};
+};
+
+struct PointLightState {
+    Vector<3> position{};
+    Vector<3> color{};
+    float radius{}, ambientStrength{};
+};
+
+struct SpotLightState {
+    Vector<3> position{};
+    Vector<3> direction{};
+    Vector<3> color{};
+    float range{}, angle{}, blurAngle{};
+};
+
+/* one camera's pass over the frame's draws, in the order the views are listed */
+struct ViewState {
+    GPU::Mat4 combined{};
+    Vector<3> viewPosition{};
+    Camera::DepthMode depthMode{ Camera::DepthMode::Standard }; /* the one `combined` was built for */
+
+    std::shared_ptr<RenderTarget> target{}; /* null draws to the window */
+    int x{}, y{}, width{}, height{};        /* viewport in pixels of the target */
+
+    std::vector<std::uint32_t> draws{}; /* indices into FrameSnapshot::draws, grouped by shader then mesh */
+    std::vector<DrawBatch> batches{};
+};
+
+/* positions (draw transforms, lights, view positions) are relative to the main camera, see RenderSystem */
+struct FrameSnapshot {
+    unsigned long frame{};
+    int width{}, height{}; /* window framebuffer size */
+
+    std::vector<ViewState> views{};
+
+    /* every draw visible in at least one view, shared between the views that see it */
+    std::vector<DrawItem> draws{};
+
+    std::vector<DirectionalLightState> directionalLights{};
+    std::vector<PointLightState> pointLights{};
+    std::vector<SpotLightState> spotLights{};
+
+    /* empty every list but keep their storage for the next frame, views keep their slots */
+    void clear();
+};
+
+/*
+ * Lock-free single producer, single consumer triple buffer. The producer always
+ * owns back(), the consumer always owns front() and the third slot is handed
+ * between them by publish() and acquire(), neither of which ever blocks.
+ */
+template <typename T>
+class TripleBuffer {
+private:
+    static constexpr unsigned int IndexMask{ 0x3 };
+    static constexpr unsigned int FreshBit{ 0x4 };
+
+    std::array<T, 3> mSlots{};
+
+    unsigned int mBack{ 0 };
+    std::atomic<unsigned int> mMiddle{ 1 };
+    unsigned int mFront{ 2 };
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    T& back() {
+        return mSlots[mBack];
+    }
+
+    const T& front() const {
+        return mSlots[mFront];
+    }
+
+    /* producer: hand back() over to the consumer and start writing into the spare slot */
+    void publish() {
+        mBack = mMiddle.exchange(mBack | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    /* consumer: swap front() for the most recently published slot, returns false if nothing new was published */
+    bool acquire() {
+        if ((mMiddle.load(std::memory_order_relaxed) & FreshBit) == 0)
+            return false;
+
+        mFront = mMiddle.exchange(mFront, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+};
+
+}
+
+#endif
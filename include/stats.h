@@ -0,0 +1,133 @@
+#ifndef BEG_STATS_H
+#define BEG_STATS_H
+
+/*
+ * Rolling frame time statistics: every named series (the whole frame and each
+ * phase of it) keeps its last Window samples for percentiles and histograms
+ * plus running totals for the whole session
+ */
+
+#include <perfcounters.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BEG {
+
+class FrameStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t Window{ 1024 };
+
+    static constexpr size_t HistogramBuckets{ 64 };
+    static constexpr double HistogramBucketWidth{ 0.0005 }; /* seconds, the last bucket collects everything above */
+
+    /* series recorded by the engine */
+    static constexpr const char* Frame{ "frame" };   /* wall time between the starts of two frames */
+    static constexpr const char* Update{ "update" }; /* main thread: running the systems */
+    static constexpr const char* Wait{ "wait" };     /* main thread: blocked on the render thread */
+    static constexpr const char* Poll{ "poll" };     /* main thread: polling window events */
+    static constexpr const char* Draw{ "draw" };     /* render thread: submitting GL work */
+    static constexpr const char* Swap{ "swap" };     /* render thread: blocked in glfwSwapBuffers */
+
+    struct Summary {
+        size_t samples{}; /* samples in the rolling window */
+        double mean{}, p50{}, p95{}, p99{}, max{};
+        size_t hitches{}; /* samples in the rolling window above the hitch threshold */
+    };
+private:
+    struct Series {
+        std::string name{};
+
+        std::array<double, Window> samples{};
+        size_t count{};
+
+        double total{}, max{};
+        size_t hitches{};
+
+        /* hardware counter totals over the samples that were taken with counters enabled */
+        PerfCounters::Values counters{};
+        size_t counted{};
+    };
+
+    mutable std::mutex mMutex{};
+    std::vector<Series> mSeries{};
+
+    double mHitchThreshold{ 1.0 / 30.0 };
+
+    Series* find(std::string_view series);
+    const Series* find(std::string_view series) const;
+    Series& findOrAdd(std::string_view series);
+    std::vector<double> window(const Series& series) const;
+public:
+    FrameStats() = default;
+    FrameStats(const FrameStats&) = delete;
+    FrameStats& operator=(const FrameStats&) = delete;
+
+    static double secondsSince(Clock::time_point start);
+
+    void record(std::string_view series, double seconds);
+    void recordCounters(std::string_view series, const PerfCounters::Values& counters);
+
+    /* rolling statistics of a series, systems are recorded under their type name (e.g. "BEG::RenderSystem") */
+    Summary summary(std::string_view series) const;
+    std::array<size_t, HistogramBuckets> histogram(std::string_view series) const;
+
+    /* names of every series recorded so far, in first-recorded order */
+    std::vector<std::string> series() const;
+
+    /* samples and hitches over the whole session, not just the rolling window */
+    size_t totalSamples(std::string_view series) const;
+    size_t totalHitches(std::string_view series) const;
+
+    /* mean hardware counter values per sample, zero if counters were never recorded for the series */
+    std::array<double, PerfCounters::CounterCount> counters(std::string_view series) const;
+
+    double hitchThreshold() const;
+    void hitchThreshold(double seconds);
+
+    /* write every series' summary, as CSV if the path ends in .csv and JSON otherwise */
+    bool write(const std::string& path) const;
+};
+
+/*
+ * Records the time spent in the enclosing scope into a series, and hardware
+ * counters when they are enabled. Counters are only read by leaf scopes: a
+ * scope with nested scopes on the same thread reports the sum of its
+ * children's counters, and the time its children spent reading them is taken
+ * out of its own timing.
+ */
+class StatsScope {
+private:
+    FrameStats& mStats;
+    std::string_view mSeries{};
+
+    FrameStats::Clock::time_point mStart{};
+
+    bool mCounting{};
+    PerfCounters::Values mCounters{};
+
+    /* the enclosing scope on this thread, and what the nested ones handed up to this one */
+    StatsScope* mParent{};
+    bool mHasChildren{};
+    PerfCounters::Values mChildCounters{};
+
+    /* time spent reading counters by this scope (outside its timed region) and by nested ones (inside it) */
+    FrameStats::Clock::duration mOwnReads{}, mChildReads{};
+public:
+    StatsScope(FrameStats& stats, std::string_view series);
+    ~StatsScope();
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef BEG_TRS_H
+#define BEG_TRS_H
+
+#include <bmath.h>
+#include <affine.h>
+
+namespace BEG {
+
+/*
+ * Translation, rotation and scale kept apart, 40 bytes against a Matrix<4>'s
+ * 64. Composition, inversion and point transforms work on the parts
+ * directly; toMatrix() is meant to be called once, when the result goes to
+ * the GPU.
+ *
+ * Like any TRS, composition is only exact when the parent's scale is
+ * uniform, a non-uniform parent scale under a rotated child would need shear.
+ * The same goes for inverse(), which throws rather than return a wrong TRS.
+ */
+enum class TRSError {
+    NonUniformScaleError
+};
+
+struct TRS {
+    Vector<3> translation{ 0.0f, 0.0f, 0.0f };
+    Quaternion rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    Vector<3> scale{ 1.0f, 1.0f, 1.0f };
+
+    static constexpr TRS identity() { return {}; }
+
+    constexpr Vector<3> transformPoint(const Vector<3>& point) const {
+        return translation + rotation.rotate(scale * point);
+    }
+
+    constexpr Vector<3> transformDirection(const Vector<3>& direction) const {
+        return rotation.rotate(scale * direction);
+    }
+
+    /* parent * child, applying the child first like the matrix product would */
+    constexpr TRS operator*(const TRS& child) const {
+        return {
+            transformPoint(child.translation),
+            rotation * child.rotation,
+            scale * child.scale
+        };
+    }
+
+    constexpr TRS& operator*=(const TRS& child) {
+        *this = *this * child;
+        return *this;
+    }
+
+    /*
+     * Uniform scale only: the inverse applies the scale after the rotation,
+     * which a TRS can only express when the scale commutes with it. Use
+     * toMatrix().inverse() for a non-uniform scale.
+     */
+    constexpr TRS inverse() const {
+        if (scale.x() != scale.y() || scale.x() != scale.z())
+            throw TRSError::NonUniformScaleError;
+
+        Quaternion inverseRotation{ rotation.conjugate() };
+        Vector<3> inverseScale{ Vector<3>(1.0f) / scale };
+
+        return {
+            -(inverseScale * inverseRotation.rotate(translation)),
+            inverseRotation,
+            inverseScale
+        };
+    }
+
+    /* blend for animation: translation and scale linearly, rotation along the shorter arc */
+    TRS interpolate(const TRS& other, Number t) const {
+        return {
+            translation.lerp(other.translation, t),
+            rotation.slerp(other.rotation, t),
+            scale.lerp(other.scale, t)
+        };
+    }
+
+    constexpr Matrix<4> toMatrix() const {
+        return Affine::trs(translation, rotation, scale);
+    }
+};
+
+static_assert(sizeof(TRS) == 40, "TRS is meant to stay 10 floats");
+
+}
+
+#endif
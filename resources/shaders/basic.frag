@@ -4,18 +4,22 @@ in vec3 vertNormal;
 in vec3 vertColor;
 in vec3 fragPosition;
 
+flat in vec3 materialAmbient;
+flat in vec3 materialDiffuse;
+flat in vec3 materialSpecular;
+flat in float materialShininess;
+flat in int lightable;
+
 out vec4 FragColor;
 
 uniform vec3 viewPosition;
 
-uniform bool lightable;
-
-uniform struct Material {
+struct Material {
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
     float shininess;
-} material;
+};
 
 uniform int numberOfDirectionalLights;
 uniform struct DirectionalLight {
@@ -110,7 +114,9 @@ vec3 calculateSpotLight(SpotLight light, Material material, vec3 vertNormal, vec
 
 void main() {
     vec3 result = vertColor;
-    if (lightable) {
+    if (lightable != 0) {
+        Material material = Material(materialAmbient, materialDiffuse, materialSpecular, materialShininess);
+
         vec3 sum = vec3(0.0f, 0.0f, 0.0f);
 
         for (int i = 0; i < numberOfDirectionalLights; ++i) {
@@ -4,18 +4,36 @@ layout (location = 0) in vec3 vPos;
 layout (location = 1) in vec3 vNorm;
 layout (location = 2) in vec3 vCol;
 
-uniform mat4 model;
+/* per instance, see BEG::InstanceData */
+layout (location = 3) in mat4 iModel;
+layout (location = 7) in vec3 iAmbient;
+layout (location = 8) in vec3 iDiffuse;
+layout (location = 9) in vec3 iSpecular;
+layout (location = 10) in vec2 iShininessLightable;
+
 uniform mat4 combined;
 
 out vec3 vertNormal;
 out vec3 vertColor;
 out vec3 fragPosition;
 
+flat out vec3 materialAmbient;
+flat out vec3 materialDiffuse;
+flat out vec3 materialSpecular;
+flat out float materialShininess;
+flat out int lightable;
+
 void main()
 {
-    gl_Position = combined * model * vec4(vPos.x, vPos.y, vPos.z, 1.0);
+    gl_Position = combined * iModel * vec4(vPos.x, vPos.y, vPos.z, 1.0);
 
-    vertNormal = normalize(mat3(transpose(inverse(model))) * vNorm);
+    vertNormal = normalize(mat3(transpose(inverse(iModel))) * vNorm);
     vertColor = vCol;
-    fragPosition = vec3(model * vec4(vPos, 1.0));
+    fragPosition = vec3(iModel * vec4(vPos, 1.0));
+
+    materialAmbient = iAmbient;
+    materialDiffuse = iDiffuse;
+    materialSpecular = iSpecular;
+    materialShininess = iShininessLightable.x;
+    lightable = iShininessLightable.y > 0.5 ? 1 : 0;
 }
\ No newline at end of file
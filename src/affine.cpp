@@ -2,30 +2,6 @@
 
 using namespace BEG;
 
-Matrix<4> Affine::translation(Number x, Number y, Number z) {
-    return {
-        1.0f, 0.0f, 0.0f, x,
-        0.0f, 1.0f, 0.0f, y,
-        0.0f, 0.0f, 1.0f, z,
-        0.0f, 0.0f, 0.0f, 1.0f
-    };
-}
-
-Matrix<4> Affine::translation(Number t) { return Affine::translation(t, t, t); }
-Matrix<4> Affine::translation(const Vector<3>& t) { return Affine::translation(t.x(), t.y(), t.z()); }
-
-Matrix<4> Affine::scale(Number x, Number y, Number z) {
-    return {
-        x,    0.0f, 0.0f, 0.0f,
-        0.0f, y,    0.0f, 0.0f,
-        0.0f, 0.0f, z,    0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f
-    };        
-}
-
-Matrix<4> Affine::scale(Number s) { return Affine::scale(s, s, s); }
-Matrix<4> Affine::scale(const Vector<3>& s) { return Affine::scale(s.x(), s.y(), s.z()); }
-
 Matrix<4> Affine::rotation(Number theta, const Vector<3>& axis) {
     Vector<3> n{ axis.normalized() };
     Number x{ n.x() }, y{ n.y() }, z{ n.z() };
@@ -2,6 +2,10 @@
 
 using namespace BEG;
 
-Matrix<4> Transform::toMatrix() const {
-    return Affine::translation(position) * orientation.toMatrix() * Affine::scale(scale);
+TRS Transform::trs(const Position& origin) const {
+    return { Vector<3>(position - origin), orientation, scale };
+}
+
+Matrix<4> Transform::toMatrix(const Position& origin) const {
+    return trs(origin).toMatrix();
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include <batch.h>
+#include <jobs.h>
+#include <profiler.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace BEG;
+
+namespace {
+
+/* the top three rows of the matrix being applied, row-major */
+using Rows = std::array<float, 12>;
+
+static_assert(sizeof(Vector<3>) == 3 * sizeof(float), "the Vector<3> kernels assume tightly packed xyz triples");
+
+/* out_r = (((0 + m_r0 x) + m_r1 y) + m_r2 z) + m_r3 w, added in the order Matrix::operator*(Vector) uses */
+inline float row(const Rows& m, size_t r, float w, float x, float y, float z) {
+    const float* k{ m.data() + (r * 4) };
+    return (((0.0f + (k[0] * x)) + (k[1] * y)) + (k[2] * z)) + (k[3] * w);
+}
+
+/* the same sums four lanes at a time, `splats` holds each matrix element broadcast with the w column premultiplied */
+inline void transform4(const SIMD::Float4 (&splats)[12], SIMD::Float4 x, SIMD::Float4 y, SIMD::Float4 z, SIMD::Float4 (&out)[3]) {
+    for (size_t r{ 0 }; r < 3; ++r) {
+        SIMD::Float4 acc{ SIMD::zero() };
+        acc = SIMD::add(acc, SIMD::mul(splats[r * 4], x));
+        acc = SIMD::add(acc, SIMD::mul(splats[(r * 4) + 1], y));
+        acc = SIMD::add(acc, SIMD::mul(splats[(r * 4) + 2], z));
+        out[r] = SIMD::add(acc, splats[(r * 4) + 3]);
+    }
+}
+
+void splat(const Rows& m, float w, SIMD::Float4 (&splats)[12]) {
+    for (size_t i{ 0 }; i < 12; ++i) {
+        splats[i] = SIMD::splat(i % 4 == 3 ? m[i] * w : m[i]);
+    }
+}
+
+void kernel(const Rows& m, float w, const float* x, const float* y, const float* z, float* ox, float* oy, float* oz, size_t count) {
+    size_t i{ 0 };
+
+#if defined(BEG_SIMD_AVX)
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx{ _mm256_loadu_ps(x + i) }, vy{ _mm256_loadu_ps(y + i) }, vz{ _mm256_loadu_ps(z + i) };
+        __m256 result[3];
+
+        for (size_t r{ 0 }; r < 3; ++r) {
+            const float* k{ m.data() + (r * 4) };
+
+            __m256 acc{ _mm256_setzero_ps() };
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(k[0]), vx));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(k[1]), vy));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(k[2]), vz));
+            result[r] = _mm256_add_ps(acc, _mm256_set1_ps(k[3] * w));
+        }
+
+        _mm256_storeu_ps(ox + i, result[0]);
+        _mm256_storeu_ps(oy + i, result[1]);
+        _mm256_storeu_ps(oz + i, result[2]);
+    }
+#endif
+
+    if constexpr (SIMD::Enabled) {
+        SIMD::Float4 splats[12];
+        splat(m, w, splats);
+
+        for (; i + 4 <= count; i += 4) {
+            SIMD::Float4 result[3];
+            transform4(splats, SIMD::load(x + i), SIMD::load(y + i), SIMD::load(z + i), result);
+
+            SIMD::store(ox + i, result[0]);
+            SIMD::store(oy + i, result[1]);
+            SIMD::store(oz + i, result[2]);
+        }
+    }
+
+    for (; i < count; ++i) {
+        float vx{ x[i] }, vy{ y[i] }, vz{ z[i] };
+
+        ox[i] = row(m, 0, w, vx, vy, vz);
+        oy[i] = row(m, 1, w, vx, vy, vz);
+        oz[i] = row(m, 2, w, vx, vy, vz);
+    }
+}
+
+/* packed xyz triples, four at a time through the interleaved loads */
+void kernel(const Rows& m, float w, const float* in, float* out, size_t count) {
+    size_t i{ 0 };
+
+    if constexpr (SIMD::Enabled) {
+        SIMD::Float4 splats[12];
+        splat(m, w, splats);
+
+        for (; i + 4 <= count; i += 4) {
+            SIMD::Float4 x, y, z, result[3];
+            SIMD::loadInterleaved3(in + (i * 3), x, y, z);
+            transform4(splats, x, y, z, result);
+            SIMD::storeInterleaved3(out + (i * 3), result[0], result[1], result[2]);
+        }
+    }
+
+    for (; i < count; ++i) {
+        const float* v{ in + (i * 3) };
+        float vx{ v[0] }, vy{ v[1] }, vz{ v[2] };
+
+        out[i * 3] = row(m, 0, w, vx, vy, vz);
+        out[(i * 3) + 1] = row(m, 1, w, vx, vy, vz);
+        out[(i * 3) + 2] = row(m, 2, w, vx, vy, vz);
+    }
+}
+
+/* same result as Vector<3>::normalized(), for component arrays `stride` floats apart */
+void normalize(float* x, float* y, float* z, size_t count, size_t stride = 1) {
+    for (size_t i{ 0 }; i < count * stride; i += stride) {
+        float length{ std::sqrt(((0.0f + (x[i] * x[i])) + (y[i] * y[i])) + (z[i] * z[i])) };
+
+        x[i] /= length;
+        y[i] /= length;
+        z[i] /= length;
+    }
+}
+
+/* split the range across the shared pool once it is big enough to pay for the wake-up */
+template <typename Fn>
+void dispatch(size_t count, const Fn& fn) {
+    if (count < Batch::ParallelThreshold) {
+        fn(0, count);
+        return;
+    }
+
+    BEG_PROFILE_SCOPE("batch transform");
+    JobPool::shared().parallelFor(count, Batch::ParallelThreshold / 4, fn);
+}
+
+void run(const Rows& m, float w, bool normalized, Batch::ConstSoA3 in, Batch::SoA3 out) {
+    size_t count{ in.x.size() };
+    if (in.y.size() != count || in.z.size() != count || out.x.size() != count || out.y.size() != count || out.z.size() != count)
+        throw Batch::BatchError::SizeMismatchError;
+
+    dispatch(count, [&](size_t begin, size_t end) {
+        kernel(m, w, in.x.data() + begin, in.y.data() + begin, in.z.data() + begin,
+               out.x.data() + begin, out.y.data() + begin, out.z.data() + begin, end - begin);
+
+        if (normalized)
+            normalize(out.x.data() + begin, out.y.data() + begin, out.z.data() + begin, end - begin);
+    });
+}
+
+void run(const Rows& m, float w, bool normalized, std::span<const Vector<3>> in, std::span<Vector<3>> out) {
+    if (in.size() != out.size())
+        throw Batch::BatchError::SizeMismatchError;
+
+    const float* source{ in.empty() ? nullptr : in[0].data().data() };
+    float* target{ out.empty() ? nullptr : out[0].data().data() };
+
+    dispatch(in.size(), [&](size_t begin, size_t end) {
+        kernel(m, w, source + (begin * 3), target + (begin * 3), end - begin);
+
+        if (normalized)
+            normalize(target + (begin * 3), target + (begin * 3) + 1, target + (begin * 3) + 2, end - begin, 3);
+    });
+}
+
+Rows rows(const Matrix<4>& matrix) {
+    Rows result{};
+    std::copy_n(matrix.data().begin(), result.size(), result.begin());
+    return result;
+}
+
+/* inverse transpose of the 3x3 block, with no translation */
+Rows normalRows(const Matrix<4>& matrix) {
+    const auto& a{ matrix.data() };
+    Matrix<3> normal{ Matrix<3>{ a[0], a[1], a[2], a[4], a[5], a[6], a[8], a[9], a[10] }.inverse().transpose() };
+    const auto& n{ normal.data() };
+
+    return { n[0], n[1], n[2], 0.0f, n[3], n[4], n[5], 0.0f, n[6], n[7], n[8], 0.0f };
+}
+
+}
+
+void Batch::transformPoints(const Matrix<4>& matrix, std::span<const Vector<3>> in, std::span<Vector<3>> out) {
+    run(rows(matrix), 1.0f, false, in, out);
+}
+
+void Batch::transformDirections(const Matrix<4>& matrix, std::span<const Vector<3>> in, std::span<Vector<3>> out) {
+    run(rows(matrix), 0.0f, false, in, out);
+}
+
+void Batch::transformNormals(const Matrix<4>& matrix, std::span<const Vector<3>> in, std::span<Vector<3>> out) {
+    run(normalRows(matrix), 0.0f, true, in, out);
+}
+
+void Batch::transformPoints(const Matrix<4>& matrix, ConstSoA3 in, SoA3 out) {
+    run(rows(matrix), 1.0f, false, in, out);
+}
+
+void Batch::transformDirections(const Matrix<4>& matrix, ConstSoA3 in, SoA3 out) {
+    run(rows(matrix), 0.0f, false, in, out);
+}
+
+void Batch::transformNormals(const Matrix<4>& matrix, ConstSoA3 in, SoA3 out) {
+    run(normalRows(matrix), 0.0f, true, in, out);
+}
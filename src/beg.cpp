@@ -17,21 +17,21 @@ struct MoverComponent : BEG::Component {
 
 class SpinSystem : public BEG::System<BEG::Transform, SpinnerComponent> {
     void update(BEG::Game& game, BEG::Transform& transform, SpinnerComponent& spinner) {
-        transform.orientation *= BEG::Quaternion(spinner.speed * game.deltaTime(), spinner.speed * game.deltaTime(), 0.0f);
+        transform.orientation *= BEG::Fast::fromEuler(spinner.speed * game.deltaTime(), spinner.speed * game.deltaTime(), 0.0f);
     }
 };
 
 class MovementSystem : public BEG::System<MoverComponent> {
     void update(BEG::Game&game, MoverComponent& mover) {        
         if (game.isKeyDown(BEG::Keyboard::Key::W)) {
-            game.camera.position += game.camera.front() * (game.deltaTime() * mover.movementSpeed);
+            game.camera.translate(game.camera.front() * (game.deltaTime() * mover.movementSpeed));
         } else if (game.isKeyDown(BEG::Keyboard::Key::S)) {
-            game.camera.position += game.camera.front() * (game.deltaTime() * -mover.movementSpeed);
+            game.camera.translate(game.camera.front() * (game.deltaTime() * -mover.movementSpeed));
         }
         if (game.isKeyDown(BEG::Keyboard::Key::A)) {
-            game.camera.position += game.camera.right() * (game.deltaTime() * -mover.movementSpeed);
+            game.camera.translate(game.camera.right() * (game.deltaTime() * -mover.movementSpeed));
         } else if (game.isKeyDown(BEG::Keyboard::Key::D)) {
-            game.camera.position += game.camera.right() * (game.deltaTime() * mover.movementSpeed);
+            game.camera.translate(game.camera.right() * (game.deltaTime() * mover.movementSpeed));
         }
 
         float dMX{ mover.mouseX - game.mouseX() };
@@ -47,14 +47,15 @@ class MovementSystem : public BEG::System<MoverComponent> {
 
         std::cout << dMX << ",  " << dMY << '\n';
 
-        game.camera.orientation = BEG::Quaternion(mover.orientation);
+        game.camera.orientation(BEG::Fast::fromEuler(mover.orientation));
     }
 };
 
 int main() {
     BEG::Game game{ "BEG", 800, 800 };
 
-    game.camera.position = BEG::Vector<3>(0.0f, 0.0f, 5.0f);
+    game.camera.position(BEG::Vector<3>(0.0f, 0.0f, 5.0f));
+    game.camera.depthMode(BEG::Camera::DepthMode::ReverseInfinite);
 
     BEG::Entity cube{ game.scene.newEntity() };
 
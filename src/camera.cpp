@@ -2,35 +2,165 @@
 
 using namespace BEG;
 
-float Camera::fov() {
+const Camera::Cache& Camera::cache() const {
+    if (mViewDirty) {
+        /* the inverse of a unit rotation is its conjugate, no general inverse needed */
+        mCache.view = mOrientation.conjugate().toMatrix();
+        mCache.inverseView = mOrientation.toMatrix();
+    }
+
+    if (mProjectionDirty) {
+        mCache.projection = perspectiveMatrix(mAspect, mNear, mFar);
+        mCache.inverseProjection = mCache.projection.inverse();
+    }
+
+    if (mViewDirty || mProjectionDirty) {
+        mCache.viewProjection = mCache.projection * mCache.view;
+        mCache.inverseViewProjection = mCache.inverseView * mCache.inverseProjection;
+        mCache.frustum = Frustum::fromMatrix(mCache.viewProjection, clipDepth());
+
+        mViewDirty = false;
+        mProjectionDirty = false;
+    }
+
+    return mCache;
+}
+
+float Camera::fov() const {
     return mFov;
 }
 
 void Camera::fov(float value) {
-    mFov = value;
+    if (value != mFov) {
+        mFov = value;
+        mProjectionDirty = true;
+    }
+}
+
+float Camera::aspect() const {
+    return mAspect;
+}
+
+void Camera::aspect(float value) {
+    if (value != mAspect) {
+        mAspect = value;
+        mProjectionDirty = true;
+    }
+}
+
+float Camera::near() const {
+    return mNear;
+}
+
+float Camera::far() const {
+    return mFar;
+}
+
+void Camera::clipPlanes(float near, float far) {
+    if (near != mNear || far != mFar) {
+        mNear = near;
+        mFar = far;
+        mProjectionDirty = true;
+    }
+}
+
+Camera::DepthMode Camera::depthMode() const {
+    return mDepthMode;
+}
+
+void Camera::depthMode(DepthMode value) {
+    if (value != mDepthMode) {
+        mDepthMode = value;
+        mProjectionDirty = true;
+    }
+}
+
+Frustum::ClipDepth Camera::clipDepth() const {
+    return mDepthMode == DepthMode::ReverseInfinite ? Frustum::ClipDepth::ReversedZeroToOne : Frustum::ClipDepth::NegativeOneToOne;
+}
+
+const Position& Camera::position() const {
+    return mPosition;
+}
+
+void Camera::position(const Position& value) {
+    mPosition = value;
+}
+
+void Camera::translate(const Vector<3>& offset) {
+    mPosition += offset;
+}
+
+const Quaternion& Camera::orientation() const {
+    return mOrientation;
+}
+
+void Camera::orientation(const Quaternion& value) {
+    mOrientation = value;
+    mViewDirty = true;
 }
 
 Vector<3> Camera::front() const {
-    return { orientation.toMatrix() * Vector<4>(0.0f, 0.0f, -1.0f, 1.0f) };
+    return mOrientation.rotate({ 0.0f, 0.0f, -1.0f });
 }
 
 Vector<3> Camera::right() const {
-    return { orientation.toMatrix() * Vector<4>(1.0f, 0.0f, 0.0f, 1.0f) };
+    return mOrientation.rotate({ 1.0f, 0.0f, 0.0f });
 }
 
 Vector<3> Camera::up() const {
-    return { orientation.toMatrix() * Vector<4>(0.0f, 1.0f, 0.0f, 1.0f) };
+    return mOrientation.rotate({ 0.0f, 1.0f, 0.0f });
+}
+
+Vector<3> Camera::relative(const Position& world) const {
+    return Vector<3>(world - mPosition);
 }
 
 Matrix<4> Camera::transformationMatrix() const {
-    return Affine::translation(position) * orientation.toMatrix();
+    return Affine::tr(Vector<3>(mPosition), mOrientation);
+}
+
+const Matrix<4>& Camera::viewMatrix() const {
+    return cache().view;
+}
+
+const Matrix<4>& Camera::inverseViewMatrix() const {
+    return cache().inverseView;
+}
+
+const Matrix<4>& Camera::projectionMatrix() const {
+    return cache().projection;
+}
+
+const Matrix<4>& Camera::inverseProjectionMatrix() const {
+    return cache().inverseProjection;
+}
+
+const Matrix<4>& Camera::viewProjectionMatrix() const {
+    return cache().viewProjection;
+}
+
+const Matrix<4>& Camera::inverseViewProjectionMatrix() const {
+    return cache().inverseViewProjection;
 }
 
-Matrix<4> Camera::viewMatrix() const {
-    return transformationMatrix().inverse();
+const Frustum& Camera::frustum() const {
+    return cache().frustum;
 }
 
 Matrix<4> Camera::perspectiveMatrix(float aspect, float near, float far) const {
+    if (mDepthMode == DepthMode::ReverseInfinite) {
+        /* clip z is the constant near and w the view distance, so depth = near / distance */
+        float focal{ 1.0f / tanf(mFov * 0.5f) };
+
+        return {
+            focal / aspect, 0.0f, 0.0f, 0.0f,
+            0.0f, focal, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, near,
+            0.0f, 0.0f, -1.0f, 0.0f
+        };
+    }
+
     float top{ tanf(mFov * 0.5f) * near };
     float bottom{ -top };
     float right{ aspect * top };
@@ -43,7 +173,3 @@ Matrix<4> Camera::perspectiveMatrix(float aspect, float near, float far) const {
         0.0f, 0.0f, -1.0f, 0.0f
     };
 }
-
-Matrix<4> Camera::combinedMatrix(float aspect, float near, float far) const {
-    return perspectiveMatrix(aspect, near, far) * viewMatrix();
-}
\ No newline at end of file
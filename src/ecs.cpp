@@ -1,4 +1,5 @@
 #include <ecs.h>
+#include <game.h>
 
 using namespace BEG;
 
@@ -31,7 +32,12 @@ bool Scene::exists(Entity entity) {
 }
 
 void Scene::setupSystems(Game& game) {
-    for (auto system : mSystems) {
+    BEG_PROFILE_SCOPE("Scene::setupSystems");
+
+    for (size_t i{ 0 }; i < mSystems.size(); ++i) {
+        BEG_PROFILE_SCOPE(mSystemNames[i]);
+
+        auto system{ mSystems[i] };
         (*system).callSetupAll(game, *this);
         for (auto entity : mEntities) {
             if ((*system).appliesTo(*this, entity)) {
@@ -42,7 +48,13 @@ void Scene::setupSystems(Game& game) {
 }
 
 void Scene::updateSystems(Game& game) {
-    for (auto system : mSystems) {
+    BEG_PROFILE_SCOPE("Scene::updateSystems");
+
+    for (size_t i{ 0 }; i < mSystems.size(); ++i) {
+        StatsScope stats{ game.frameStats(), mSystemNames[i] };
+        BEG_PROFILE_SCOPE(mSystemNames[i]);
+
+        auto system{ mSystems[i] };
         (*system).callUpdateAll(game, *this);
         for (auto entity : mEntities) {
             if ((*system).appliesTo(*this, entity)) {
@@ -3,10 +3,9 @@
 using namespace BEG;
 
 void Game::framebufferSizeHandler(int width, int height) {
+    /* the viewport itself is set by the renderer, which owns the GL context */
     mWindowWidth = width;
     mWindowHeight = height;
-
-    glViewport(0, 0, mWindowWidth, mWindowHeight);
 }
 
 Game::Game(const std::string& name, int width, int height)
@@ -32,8 +31,8 @@ Game::Game(const std::string& name, int width, int height)
         throw Game::GameError::GLADInitError;
     }
 
+    /* the depth function, clear value and clip range follow camera.depthMode(), the renderer sets them per frame */
     glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
 
     glViewport(0, 0, mWindowWidth, mWindowHeight);
 
@@ -88,20 +87,84 @@ float Game::changeInMouseY() const { return mMouse.changeInY(); }
 
 float Game::deltaTime() const { return mDeltaTime; }
 
+FrameSnapshot& Game::snapshot() { return mSnapshots.back(); }
+
+FrameStats& Game::frameStats() { return mStats; }
+const FrameStats& Game::frameStats() const { return mStats; }
+
+void Game::statsOnExit(const std::string& path) { mStatsPath = path; }
+
 void Game::begin() {
+    BEG_PROFILE_THREAD("main");
+
+    /* BEG_PERF=1 samples hardware counters per phase and per system into the frame stats */
+    if (const char* perf{ std::getenv("BEG_PERF") }; perf != nullptr && std::string(perf) != "0")
+        PerfCounters::enable(true);
+
     scene.setupSystems(*this);
 
+    mRenderThread.start(mWindow);
+
     while (!glfwWindowShouldClose(mWindow)) {
+        BEG_PROFILE_FRAME();
+
         float currTime{ static_cast<float>(glfwGetTime()) };
         mDeltaTime = currTime - mPrevTime;
         mPrevTime = currTime;
 
+        /* the first delta spans startup, not a frame */
+        if (mFrame > 0)
+            mStats.record(FrameStats::Frame, mDeltaTime);
+
         if(isKeyDown(Keyboard::Key::Escape))
             glfwSetWindowShouldClose(mWindow, true);
 
-        scene.updateSystems(*this);
+#ifdef BEG_PROFILE
+        /* on the press only, the dump itself is written at the next frame boundary */
+        if (isKeyDown(TraceKey) && !mTraceKeyDown)
+            Profiler::requestDump("trace-" + std::to_string(mFrame) + ".json", TraceKeyFrames);
+        mTraceKeyDown = isKeyDown(TraceKey);
+#endif
+
+        mSnapshots.back().frame = mFrame;
 
-        glfwSwapBuffers(mWindow);
-        glfwPollEvents();
+        {
+            StatsScope stats{ mStats, FrameStats::Update };
+            BEG_PROFILE_SCOPE("update");
+            scene.updateSystems(*this);
+        }
+
+        mSnapshots.back().width = mWindowWidth;
+        mSnapshots.back().height = mWindowHeight;
+
+        /* fence: frame N-1 must be drawn before frame N is handed over, the simulation then moves on to N+1 */
+        {
+            StatsScope stats{ mStats, FrameStats::Wait };
+            BEG_PROFILE_SCOPE("wait");
+            mRenderThread.waitForFrame(mFrame);
+        }
+
+        mSnapshots.publish();
+        mRenderThread.submitFrame();
+        ++mFrame;
+
+        {
+            StatsScope stats{ mStats, FrameStats::Poll };
+            BEG_PROFILE_SCOPE("poll");
+            glfwPollEvents();
+        }
     }
+
+    mRenderThread.stop();
+
+    /* BEG_TRACE=<path> exports the last frames when the game exits, in BEG_PROFILE builds */
+    if (const char* tracePath{ std::getenv("BEG_TRACE") }; tracePath != nullptr)
+        BEG_PROFILE_DUMP(tracePath, Profiler::MaxFrames);
+
+    /* BEG_STATS=<path> does the same as statsOnExit() */
+    if (const char* statsPath{ std::getenv("BEG_STATS") }; statsPath != nullptr)
+        mStatsPath = statsPath;
+
+    if (!mStatsPath.empty())
+        mStats.write(mStatsPath);
 }
\ No newline at end of file
@@ -0,0 +1,377 @@
+#include <geometry.h>
+#include <jobs.h>
+#include <profiler.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace BEG;
+
+namespace {
+
+/* below this many elements a single thread is faster than waking the pool, same figure as Batch */
+constexpr size_t ParallelThreshold{ 16384 };
+
+/* minps/maxps semantics, the second operand wins when either is NaN, so the scalar and SIMD slab tests agree */
+inline float lowest(float a, float b) { return a < b ? a : b; }
+inline float highest(float a, float b) { return a > b ? a : b; }
+
+inline float absolute(float value) { return value < 0.0f ? -value : value; }
+
+/*
+ * Run kernel(begin, end, words) over the elements a word of the mask at a
+ * time, so no two chunks ever write the same word.
+ */
+template <typename Fn>
+void dispatch(size_t count, std::span<std::uint64_t> mask, const Fn& kernel) {
+    size_t words{ maskWords(count) };
+    if (mask.size() < words)
+        throw GeometryError::SizeMismatchError;
+
+    auto run = [&](size_t first, size_t last) {
+        for (size_t w{ first }; w < last; ++w) {
+            mask[w] = 0;
+        }
+
+        size_t begin{ first * 64 }, end{ last * 64 < count ? last * 64 : count };
+        kernel(begin, end, mask.data());
+    };
+
+    if (count < ParallelThreshold) {
+        run(0, words);
+        return;
+    }
+
+    BEG_PROFILE_SCOPE("geometry test");
+    JobPool::shared().parallelFor(words, ParallelThreshold / 256, run);
+}
+
+/* set `bits` (one per element from `index` on) in the mask, chunks never straddle a word since 64 is a multiple of 4 and 8 */
+inline void write(std::uint64_t* mask, size_t index, unsigned bits) {
+    mask[index / 64] |= static_cast<std::uint64_t>(bits) << (index % 64);
+}
+
+}
+
+Plane Plane::fromPoints(const Vector<3>& a, const Vector<3>& b, const Vector<3>& c) {
+    Vector<3> normal{ (b - a).cross(c - a).normalized() };
+    return fromPointNormal(a, normal);
+}
+
+Plane Plane::normalized() const {
+    Number length{ normal.magnitude() };
+    return { normal / length, distance / length };
+}
+
+Plane Plane::transformed(const Matrix<4>& matrix) const {
+    Vector<4> result{ matrix.inverseAffine().transpose() * Vector<4>(normal, distance) };
+    return Plane{ Vector<3>(result), result.w() }.normalized();
+}
+
+Sphere Sphere::merged(const Sphere& other) const {
+    Vector<3> offset{ other.center - center };
+    Number span{ offset.magnitude() };
+
+    if (span + other.radius <= radius)
+        return *this;
+    if (span + radius <= other.radius)
+        return other;
+
+    Number mergedRadius{ (span + radius + other.radius) * 0.5f };
+    return { center + (offset * ((mergedRadius - radius) / span)), mergedRadius };
+}
+
+Sphere Sphere::transformed(const Matrix<4>& matrix) const {
+    Number scale{ 0.0f };
+
+    for (size_t c{ 0 }; c < 3; ++c) {
+        Vector<3> column{ matrix.at(0, c), matrix.at(1, c), matrix.at(2, c) };
+        scale = std::max(scale, column.dot(column));
+    }
+
+    return { Vector<3>(matrix * Vector<4>(center, 1.0f)), radius * sqrtf(scale) };
+}
+
+AABB Sphere::bounds() const {
+    return AABB::fromCenterExtents(center, Vector<3>(radius));
+}
+
+Sphere AABB::boundingSphere() const {
+    return { center(), extents().magnitude() };
+}
+
+std::optional<Number> Ray::intersect(const AABB& box, Number maxDistance) const {
+    Number enter{ 0.0f }, exit{ maxDistance };
+
+    for (size_t i{ 0 }; i < 3; ++i) {
+        Number inverse{ 1.0f / direction[i] };
+        Number t1{ (box.min[i] - origin[i]) * inverse };
+        Number t2{ (box.max[i] - origin[i]) * inverse };
+
+        enter = highest(lowest(t1, t2), enter);
+        exit = lowest(highest(t1, t2), exit);
+    }
+
+    if (enter <= exit)
+        return enter;
+
+    return std::nullopt;
+}
+
+std::optional<Number> Ray::intersect(const Sphere& sphere, Number maxDistance) const {
+    Vector<3> offset{ origin - sphere.center };
+    Number a{ direction.dot(direction) };
+    Number b{ direction.dot(offset) };
+    Number c{ offset.dot(offset) - (sphere.radius * sphere.radius) };
+
+    if (c <= 0.0f)
+        return 0.0f;
+
+    /* from outside a hit needs real roots with the sphere ahead, and then the nearer root is it */
+    Number discriminant{ (b * b) - (a * c) };
+    if (discriminant < 0.0f || b > 0.0f)
+        return std::nullopt;
+
+    Number t{ (-b - sqrtf(discriminant)) / a };
+    if (t > maxDistance)
+        return std::nullopt;
+
+    return t;
+}
+
+std::optional<Number> Ray::intersect(const Plane& plane, Number maxDistance) const {
+    Number facing{ plane.normal.dot(direction) };
+    if (facing == 0.0f)
+        return std::nullopt;
+
+    Number t{ -plane.signedDistance(origin) / facing };
+    if (t < 0.0f || t > maxDistance)
+        return std::nullopt;
+
+    return t;
+}
+
+void Ray::test(const AABBSoA& boxes, std::span<std::uint64_t> hits, Number maxDistance) const {
+    size_t count{ boxes.centerX.size() };
+    if (boxes.centerY.size() != count || boxes.centerZ.size() != count
+        || boxes.extentX.size() != count || boxes.extentY.size() != count || boxes.extentZ.size() != count)
+        throw GeometryError::SizeMismatchError;
+
+    const float* center[3]{ boxes.centerX.data(), boxes.centerY.data(), boxes.centerZ.data() };
+    const float* extent[3]{ boxes.extentX.data(), boxes.extentY.data(), boxes.extentZ.data() };
+    float inverse[3]{ 1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2] };
+
+    dispatch(count, hits, [&](size_t begin, size_t end, std::uint64_t* mask) {
+        size_t i{ begin };
+
+#if defined(BEG_SIMD_AVX)
+        for (; i + 8 <= end; i += 8) {
+            __m256 enter{ _mm256_setzero_ps() }, exit{ _mm256_set1_ps(maxDistance) };
+
+            for (size_t k{ 0 }; k < 3; ++k) {
+                __m256 c{ _mm256_loadu_ps(center[k] + i) }, e{ _mm256_loadu_ps(extent[k] + i) };
+                __m256 o{ _mm256_set1_ps(origin[k]) }, d{ _mm256_set1_ps(inverse[k]) };
+                __m256 t1{ _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(c, e), o), d) };
+                __m256 t2{ _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(c, e), o), d) };
+
+                enter = _mm256_max_ps(_mm256_min_ps(t1, t2), enter);
+                exit = _mm256_min_ps(_mm256_max_ps(t1, t2), exit);
+            }
+
+            write(mask, i, static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(enter, exit, _CMP_LE_OQ))));
+        }
+#endif
+
+        if constexpr (SIMD::Enabled) {
+            for (; i + 4 <= end; i += 4) {
+                SIMD::Float4 enter{ SIMD::zero() }, exit{ SIMD::splat(maxDistance) };
+
+                for (size_t k{ 0 }; k < 3; ++k) {
+                    SIMD::Float4 c{ SIMD::load(center[k] + i) }, e{ SIMD::load(extent[k] + i) };
+                    SIMD::Float4 o{ SIMD::splat(origin[k]) }, d{ SIMD::splat(inverse[k]) };
+                    SIMD::Float4 t1{ SIMD::mul(SIMD::sub(SIMD::sub(c, e), o), d) };
+                    SIMD::Float4 t2{ SIMD::mul(SIMD::sub(SIMD::add(c, e), o), d) };
+
+                    enter = SIMD::max(SIMD::min(t1, t2), enter);
+                    exit = SIMD::min(SIMD::max(t1, t2), exit);
+                }
+
+                write(mask, i, SIMD::bits(SIMD::lessEqual(enter, exit)));
+            }
+        }
+
+        for (; i < end; ++i) {
+            Vector<3> c{ center[0][i], center[1][i], center[2][i] }, e{ extent[0][i], extent[1][i], extent[2][i] };
+
+            if (intersect(AABB::fromCenterExtents(c, e), maxDistance))
+                write(mask, i, 1);
+        }
+    });
+}
+
+Frustum Frustum::fromMatrix(const Matrix<4>& viewProjection, ClipDepth depth) {
+    Vector<4> rows[4];
+
+    for (size_t r{ 0 }; r < 4; ++r) {
+        rows[r] = { viewProjection.at(r, 0), viewProjection.at(r, 1), viewProjection.at(r, 2), viewProjection.at(r, 3) };
+    }
+
+    /* a point is inside when -w <= x, y <= w in clip space and z is in the depth range, each bound is one plane */
+    Vector<4> sides[Side::Count]{
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2]
+    };
+
+    if (depth == ClipDepth::ZeroToOne) {
+        sides[Side::Near] = rows[2];
+    } else if (depth == ClipDepth::ReversedZeroToOne) {
+        sides[Side::Near] = rows[3] - rows[2];
+        sides[Side::Far] = rows[2];
+    }
+
+    Frustum result{};
+
+    for (size_t i{ 0 }; i < Side::Count; ++i) {
+        Plane plane{ Vector<3>(sides[i]), sides[i].w() };
+        result.planes[i] = plane.normal.magnitude() == 0.0f ? Plane{ { 0.0f, 0.0f, 0.0f }, 1.0f } : plane.normalized();
+    }
+
+    return result;
+}
+
+void Frustum::test(const AABBSoA& boxes, std::span<std::uint64_t> visible) const {
+    size_t count{ boxes.centerX.size() };
+    if (boxes.centerY.size() != count || boxes.centerZ.size() != count
+        || boxes.extentX.size() != count || boxes.extentY.size() != count || boxes.extentZ.size() != count)
+        throw GeometryError::SizeMismatchError;
+
+    dispatch(count, visible, [&](size_t begin, size_t end, std::uint64_t* mask) {
+        size_t i{ begin };
+
+#if defined(BEG_SIMD_AVX)
+        for (; i + 8 <= end; i += 8) {
+            __m256 cx{ _mm256_loadu_ps(boxes.centerX.data() + i) }, cy{ _mm256_loadu_ps(boxes.centerY.data() + i) }, cz{ _mm256_loadu_ps(boxes.centerZ.data() + i) };
+            __m256 ex{ _mm256_loadu_ps(boxes.extentX.data() + i) }, ey{ _mm256_loadu_ps(boxes.extentY.data() + i) }, ez{ _mm256_loadu_ps(boxes.extentZ.data() + i) };
+            __m256 outside{ _mm256_setzero_ps() };
+
+            for (const Plane& plane : planes) {
+                const Vector<3>& n{ plane.normal };
+
+                __m256 distance{ _mm256_setzero_ps() };
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(n.x()), cx));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(n.y()), cy));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(n.z()), cz));
+                distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.distance));
+
+                __m256 reach{ _mm256_setzero_ps() };
+                reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_set1_ps(absolute(n.x())), ex));
+                reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_set1_ps(absolute(n.y())), ey));
+                reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_set1_ps(absolute(n.z())), ez));
+
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            write(mask, i, ~static_cast<unsigned>(_mm256_movemask_ps(outside)) & 0xffu);
+        }
+#endif
+
+        if constexpr (SIMD::Enabled) {
+            /* per plane: the normal, the distance and the absolute normal, broadcast once */
+            SIMD::Float4 splats[Side::Count][7];
+            for (size_t p{ 0 }; p < Side::Count; ++p) {
+                const Vector<3>& n{ planes[p].normal };
+                float values[7]{ n.x(), n.y(), n.z(), planes[p].distance, absolute(n.x()), absolute(n.y()), absolute(n.z()) };
+
+                for (size_t k{ 0 }; k < 7; ++k) {
+                    splats[p][k] = SIMD::splat(values[k]);
+                }
+            }
+
+            for (; i + 4 <= end; i += 4) {
+                SIMD::Float4 cx{ SIMD::load(boxes.centerX.data() + i) }, cy{ SIMD::load(boxes.centerY.data() + i) }, cz{ SIMD::load(boxes.centerZ.data() + i) };
+                SIMD::Float4 ex{ SIMD::load(boxes.extentX.data() + i) }, ey{ SIMD::load(boxes.extentY.data() + i) }, ez{ SIMD::load(boxes.extentZ.data() + i) };
+                SIMD::Float4 outside{ SIMD::zero() };
+
+                for (const SIMD::Float4 (&k)[7] : splats) {
+                    SIMD::Float4 distance{ SIMD::zero() };
+                    distance = SIMD::add(distance, SIMD::mul(k[0], cx));
+                    distance = SIMD::add(distance, SIMD::mul(k[1], cy));
+                    distance = SIMD::add(distance, SIMD::mul(k[2], cz));
+                    distance = SIMD::add(distance, k[3]);
+
+                    SIMD::Float4 reach{ SIMD::zero() };
+                    reach = SIMD::add(reach, SIMD::mul(k[4], ex));
+                    reach = SIMD::add(reach, SIMD::mul(k[5], ey));
+                    reach = SIMD::add(reach, SIMD::mul(k[6], ez));
+
+                    outside = SIMD::maskOr(outside, SIMD::less(SIMD::add(distance, reach), SIMD::zero()));
+                }
+
+                write(mask, i, ~SIMD::bits(outside) & 0xfu);
+            }
+        }
+
+        for (; i < end; ++i) {
+            Vector<3> c{ boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i] }, e{ boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i] };
+
+            if (intersects(c, e))
+                write(mask, i, 1);
+        }
+    });
+}
+
+void Frustum::test(const SphereSoA& spheres, std::span<std::uint64_t> visible) const {
+    size_t count{ spheres.x.size() };
+    if (spheres.y.size() != count || spheres.z.size() != count || spheres.radius.size() != count)
+        throw GeometryError::SizeMismatchError;
+
+    dispatch(count, visible, [&](size_t begin, size_t end, std::uint64_t* mask) {
+        size_t i{ begin };
+
+#if defined(BEG_SIMD_AVX)
+        for (; i + 8 <= end; i += 8) {
+            __m256 x{ _mm256_loadu_ps(spheres.x.data() + i) }, y{ _mm256_loadu_ps(spheres.y.data() + i) }, z{ _mm256_loadu_ps(spheres.z.data() + i) };
+            __m256 reach{ _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres.radius.data() + i)) };
+            __m256 outside{ _mm256_setzero_ps() };
+
+            for (const Plane& plane : planes) {
+                __m256 distance{ _mm256_setzero_ps() };
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal.x()), x));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal.y()), y));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal.z()), z));
+                distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.distance));
+
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, reach, _CMP_LT_OQ));
+            }
+
+            write(mask, i, ~static_cast<unsigned>(_mm256_movemask_ps(outside)) & 0xffu);
+        }
+#endif
+
+        if constexpr (SIMD::Enabled) {
+            for (; i + 4 <= end; i += 4) {
+                SIMD::Float4 x{ SIMD::load(spheres.x.data() + i) }, y{ SIMD::load(spheres.y.data() + i) }, z{ SIMD::load(spheres.z.data() + i) };
+                SIMD::Float4 reach{ SIMD::sub(SIMD::zero(), SIMD::load(spheres.radius.data() + i)) };
+                SIMD::Float4 outside{ SIMD::zero() };
+
+                for (const Plane& plane : planes) {
+                    SIMD::Float4 distance{ SIMD::zero() };
+                    distance = SIMD::add(distance, SIMD::mul(SIMD::splat(plane.normal.x()), x));
+                    distance = SIMD::add(distance, SIMD::mul(SIMD::splat(plane.normal.y()), y));
+                    distance = SIMD::add(distance, SIMD::mul(SIMD::splat(plane.normal.z()), z));
+                    distance = SIMD::add(distance, SIMD::splat(plane.distance));
+
+                    outside = SIMD::maskOr(outside, SIMD::less(distance, reach));
+                }
+
+                write(mask, i, ~SIMD::bits(outside) & 0xfu);
+            }
+        }
+
+        for (; i < end; ++i) {
+            if (intersects(Sphere{ { spheres.x[i], spheres.y[i], spheres.z[i] }, spheres.radius[i] }))
+                write(mask, i, 1);
+        }
+    });
+}
@@ -0,0 +1,46 @@
+#include <gpu.h>
+
+using namespace BEG;
+
+void GPU::convert(std::span<const Vector<3>> in, std::span<Vec3> out) {
+    if (in.size() != out.size())
+        throw GPUError::SizeMismatchError;
+
+    size_t i{ 0 };
+
+    if constexpr (SIMD::Enabled) {
+        /* four packed xyz triples in, transposed into four padded columns */
+        for (; i + 4 <= in.size(); i += 4) {
+            SIMD::Float4 x, y, z, w{ SIMD::zero() };
+            SIMD::loadInterleaved3(in[i].data().data(), x, y, z);
+            SIMD::transpose(x, y, z, w);
+
+            SIMD::store(&out[i].x, x);
+            SIMD::store(&out[i + 1].x, y);
+            SIMD::store(&out[i + 2].x, z);
+            SIMD::store(&out[i + 3].x, w);
+        }
+    }
+
+    for (; i < in.size(); ++i) {
+        out[i] = in[i];
+    }
+}
+
+void GPU::convert(std::span<const Vector<4>> in, std::span<Vec4> out) {
+    if (in.size() != out.size())
+        throw GPUError::SizeMismatchError;
+
+    for (size_t i{ 0 }; i < in.size(); ++i) {
+        out[i] = in[i];
+    }
+}
+
+void GPU::convert(std::span<const Matrix<4>> in, std::span<Mat4> out) {
+    if (in.size() != out.size())
+        throw GPUError::SizeMismatchError;
+
+    for (size_t i{ 0 }; i < in.size(); ++i) {
+        SIMD::transposeMatrix4(in[i].data().data(), &out[i].columns[0][0]);
+    }
+}
@@ -0,0 +1,128 @@
+#include <jobs.h>
+#include <profiler.h>
+
+#include <algorithm>
+#include <string>
+
+using namespace BEG;
+
+namespace {
+
+/* set while a thread runs a chunk, so a nested parallelFor runs inline instead of waiting on itself */
+thread_local bool tInsideJob{ false };
+
+}
+
+JobPool::JobPool(size_t threads) {
+    mWorkers.reserve(threads);
+    for (size_t i{ 0 }; i < threads; ++i) {
+        mWorkers.emplace_back(&JobPool::work, this, i);
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> lock{ mMutex };
+        mStopping = true;
+    }
+    mWake.notify_all();
+
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+size_t JobPool::defaultThreads() {
+    unsigned int hardware{ std::thread::hardware_concurrency() };
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+JobPool& JobPool::shared() {
+    static JobPool pool{};
+    return pool;
+}
+
+size_t JobPool::threads() const {
+    return mWorkers.size();
+}
+
+void JobPool::work([[maybe_unused]] size_t index) {
+    BEG_PROFILE_THREAD(Profiler::intern("worker " + std::to_string(index)));
+
+    std::uint64_t seen{ 0 };
+    std::unique_lock<std::mutex> lock{ mMutex };
+
+    for (;;) {
+        mWake.wait(lock, [this, seen] { return mStopping || mGeneration != seen; });
+        if (mStopping)
+            return;
+
+        seen = mGeneration;
+        drain(lock);
+    }
+}
+
+void JobPool::drain(std::unique_lock<std::mutex>& lock) {
+    ++mBusy;
+
+    while (mNext < mCount) {
+        size_t begin{ mNext };
+        size_t end{ std::min(begin + mGrain, mCount) };
+        mNext = end;
+
+        lock.unlock();
+        tInsideJob = true;
+        try {
+            BEG_PROFILE_SCOPE("job");
+            (*mTask)(begin, end);
+        } catch (...) {
+            tInsideJob = false;
+            lock.lock();
+            if (!mError)
+                mError = std::current_exception();
+            /* skip whatever has not been claimed yet */
+            mNext = mCount;
+            continue;
+        }
+        tInsideJob = false;
+        lock.lock();
+    }
+
+    if (--mBusy == 0)
+        mIdle.notify_all();
+}
+
+void JobPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0)
+        return;
+
+    grain = std::max<size_t>(grain, 1);
+
+    if (mWorkers.empty() || tInsideJob || count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit{ mSubmitMutex };
+    std::unique_lock<std::mutex> lock{ mMutex };
+
+    mTask = &fn;
+    mCount = count;
+    mGrain = grain;
+    mNext = 0;
+    mError = nullptr;
+    ++mGeneration;
+    mWake.notify_all();
+
+    drain(lock);
+    mIdle.wait(lock, [this] { return mBusy == 0; });
+
+    mTask = nullptr;
+    mCount = 0;
+
+    if (mError) {
+        std::exception_ptr error{ mError };
+        mError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
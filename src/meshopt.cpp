@@ -0,0 +1,333 @@
+#include <meshopt.h>
+
+#include <numeric>
+
+using namespace BEG;
+using namespace BEG::MeshOptimizer;
+
+namespace {
+
+constexpr unsigned int Unused{ ~0u };
+
+void validate(std::span<const unsigned int> indices, size_t vertexCount) {
+    if (indices.size() % 3 != 0)
+        throw MeshOptimizerError::IncompleteTriangleError;
+
+    for (unsigned int index : indices) {
+        if (index >= vertexCount)
+            throw MeshOptimizerError::IndexOutOfRangeError;
+    }
+}
+
+/* FIFO post-transform cache: a vertex hits while fewer than `size` misses happened since it was loaded */
+class CacheSimulation {
+private:
+    std::vector<size_t> mLoaded{};
+    size_t mMisses{};
+    size_t mSize{};
+public:
+    CacheSimulation(size_t vertexCount, size_t size) : mLoaded(vertexCount, 0), mMisses{ 0 }, mSize{ size } {}
+
+    /* true on a miss; mLoaded stores the miss count after loading, so 0 means never loaded */
+    bool access(unsigned int vertex) {
+        if (mLoaded[vertex] != 0 && mMisses - mLoaded[vertex] < mSize)
+            return false;
+
+        mLoaded[vertex] = ++mMisses;
+        return true;
+    }
+
+    /* the misses of triangle t of a list */
+    size_t access(std::span<const unsigned int> indices, size_t t) {
+        size_t misses{ 0 };
+        for (size_t corner{ 0 }; corner < 3; ++corner) {
+            misses += access(indices[(t * 3) + corner]) ? 1u : 0u;
+        }
+        return misses;
+    }
+
+    /* forget everything, as if the cluster started the draw */
+    void flush() {
+        mMisses += mSize;
+    }
+
+    size_t misses() const { return mMisses; }
+};
+
+/* vertex to triangle adjacency, the triangles of vertex v are triangles[offsets[v]..offsets[v + 1]) */
+struct Adjacency {
+    std::vector<unsigned int> offsets{};
+    std::vector<unsigned int> triangles{};
+
+    Adjacency(std::span<const unsigned int> indices, size_t vertexCount) : offsets(vertexCount + 1, 0), triangles(indices.size()) {
+        for (unsigned int index : indices) {
+            ++offsets[index + 1];
+        }
+
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i{ 0 }; i < indices.size(); ++i) {
+            triangles[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+};
+
+}
+
+CacheStats MeshOptimizer::analyzeVertexCache(std::span<const unsigned int> indices, size_t vertexCount, size_t cacheSize) {
+    validate(indices, vertexCount);
+
+    CacheSimulation cache{ vertexCount, cacheSize };
+    std::vector<bool> referenced(vertexCount, false);
+    size_t unique{ 0 };
+
+    for (unsigned int index : indices) {
+        cache.access(index);
+
+        if (!referenced[index]) {
+            referenced[index] = true;
+            ++unique;
+        }
+    }
+
+    CacheStats stats{};
+    stats.transformed = cache.misses();
+    stats.acmr = indices.empty() ? 0.0 : static_cast<double>(stats.transformed) / static_cast<double>(indices.size() / 3);
+    stats.atvr = unique == 0 ? 0.0 : static_cast<double>(stats.transformed) / static_cast<double>(unique);
+    return stats;
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeVertexCache(std::span<const unsigned int> indices, size_t vertexCount, size_t cacheSize) {
+    validate(indices, vertexCount);
+
+    std::vector<unsigned int> result{};
+    result.reserve(indices.size());
+
+    if (indices.empty())
+        return result;
+
+    Adjacency adjacency{ indices, vertexCount };
+
+    std::vector<unsigned int> live(vertexCount);
+    for (size_t v{ 0 }; v < vertexCount; ++v) {
+        live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+
+    std::vector<size_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(indices.size() / 3, false);
+    std::vector<unsigned int> deadEnd{}, candidates{};
+    size_t time{ cacheSize + 1 };
+    size_t cursor{ 0 };
+
+    /* a vertex with triangles left, the most recently touched first, otherwise the next in input order */
+    auto skipDeadEnd{ [&]() -> unsigned int {
+        while (!deadEnd.empty()) {
+            unsigned int vertex{ deadEnd.back() };
+            deadEnd.pop_back();
+
+            if (live[vertex] > 0)
+                return vertex;
+        }
+
+        for (; cursor < vertexCount; ++cursor) {
+            if (live[cursor] > 0)
+                return static_cast<unsigned int>(cursor);
+        }
+
+        return Unused;
+    } };
+
+    unsigned int fanning{ indices[0] };
+
+    while (fanning != Unused) {
+        candidates.clear();
+
+        for (unsigned int k{ adjacency.offsets[fanning] }; k < adjacency.offsets[fanning + 1]; ++k) {
+            unsigned int triangle{ adjacency.triangles[k] };
+            if (emitted[triangle])
+                continue;
+
+            for (size_t corner{ 0 }; corner < 3; ++corner) {
+                unsigned int vertex{ indices[(triangle * 3) + corner] };
+
+                result.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                --live[vertex];
+
+                if (time - cacheTime[vertex] > cacheSize)
+                    cacheTime[vertex] = time++;
+            }
+
+            emitted[triangle] = true;
+        }
+
+        /* the candidate still in cache after its remaining triangles are emitted, the oldest such one */
+        unsigned int next{ Unused };
+        size_t best{ 0 };
+
+        for (unsigned int vertex : candidates) {
+            if (live[vertex] == 0)
+                continue;
+
+            size_t age{ time - cacheTime[vertex] };
+            size_t priority{ age + (2 * live[vertex]) <= cacheSize ? age : 0 };
+
+            if (next == Unused || priority > best) {
+                next = vertex;
+                best = priority;
+            }
+        }
+
+        fanning = next != Unused && best > 0 ? next : skipDeadEnd();
+    }
+
+    return result;
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeOverdraw(std::span<const unsigned int> indices, std::span<const Vector<3>> positions,
+                                                          size_t cacheSize, float threshold) {
+    validate(indices, positions.size());
+
+    size_t triangles{ indices.size() / 3 };
+    if (triangles == 0)
+        return { indices.begin(), indices.end() };
+
+    /* hard boundaries: triangles that miss on all three corners start where the cache was cold anyway */
+    std::vector<size_t> hard{};
+    {
+        CacheSimulation cache{ positions.size(), cacheSize };
+
+        for (size_t t{ 0 }; t < triangles; ++t) {
+            if (cache.access(indices, t) == 3 || t == 0)
+                hard.push_back(t);
+        }
+
+        hard.push_back(triangles);
+    }
+
+    /* soft boundaries: within each hard cluster, cut wherever the part so far is already within threshold of the cluster's ACMR */
+    std::vector<size_t> boundaries{};
+    {
+        CacheSimulation cache{ positions.size(), cacheSize };
+
+        for (size_t h{ 0 }; h + 1 < hard.size(); ++h) {
+            size_t begin{ hard[h] }, end{ hard[h + 1] };
+
+            cache.flush();
+            size_t clusterMisses{ 0 };
+            for (size_t t{ begin }; t < end; ++t) {
+                clusterMisses += cache.access(indices, t);
+            }
+            double limit{ static_cast<double>(threshold) * static_cast<double>(clusterMisses) / static_cast<double>(end - begin) };
+
+            cache.flush();
+            boundaries.push_back(begin);
+            size_t start{ begin }, misses{ 0 };
+
+            for (size_t t{ begin }; t < end; ++t) {
+                misses += cache.access(indices, t);
+
+                size_t length{ t + 1 - start };
+                if (t + 1 < end && length >= cacheSize && static_cast<double>(misses) / static_cast<double>(length) <= limit) {
+                    boundaries.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    cache.flush();
+                }
+            }
+        }
+
+        boundaries.push_back(triangles);
+    }
+
+    /* each cluster's area-weighted centroid and normal, against the mesh centroid */
+    size_t clusters{ boundaries.size() - 1 };
+    std::vector<Vector<3>> centroids(clusters), normals(clusters);
+    Vector<3> meshCentroid{ 0.0f, 0.0f, 0.0f };
+    Number meshArea{ 0.0f };
+
+    for (size_t cluster{ 0 }; cluster < clusters; ++cluster) {
+        Vector<3> centroid{ 0.0f, 0.0f, 0.0f }, normal{ 0.0f, 0.0f, 0.0f };
+        Number area{ 0.0f };
+
+        for (size_t t{ boundaries[cluster] }; t < boundaries[cluster + 1]; ++t) {
+            const Vector<3>& a{ positions[indices[t * 3]] };
+            const Vector<3>& b{ positions[indices[(t * 3) + 1]] };
+            const Vector<3>& c{ positions[indices[(t * 3) + 2]] };
+
+            /* twice the triangle's area along its normal */
+            Vector<3> cross{ (b - a).cross(c - a) };
+            Number weight{ cross.magnitude() };
+
+            centroid += (a + b + c) * (weight / 3.0f);
+            normal += cross;
+            area += weight;
+        }
+
+        meshCentroid += centroid;
+        meshArea += area;
+
+        centroids[cluster] = area > 0.0f ? centroid / area : centroid;
+        Number length{ normal.magnitude() };
+        normals[cluster] = length > 0.0f ? normal / length : normal;
+    }
+
+    if (meshArea > 0.0f)
+        meshCentroid = meshCentroid / meshArea;
+
+    std::vector<Number> facing(clusters);
+    for (size_t cluster{ 0 }; cluster < clusters; ++cluster) {
+        facing[cluster] = (centroids[cluster] - meshCentroid).dot(normals[cluster]);
+    }
+
+    std::vector<size_t> order(clusters);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return facing[a] > facing[b]; });
+
+    std::vector<unsigned int> result{};
+    result.reserve(indices.size());
+
+    for (size_t cluster : order) {
+        result.insert(result.end(),
+            indices.begin() + static_cast<std::ptrdiff_t>(boundaries[cluster] * 3),
+            indices.begin() + static_cast<std::ptrdiff_t>(boundaries[cluster + 1] * 3));
+    }
+
+    return result;
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeVertexFetch(std::span<unsigned int> indices, size_t vertexCount) {
+    validate(indices, vertexCount);
+
+    std::vector<unsigned int> remap(vertexCount, Unused);
+    unsigned int next{ 0 };
+
+    for (unsigned int& index : indices) {
+        if (remap[index] == Unused)
+            remap[index] = next++;
+
+        index = remap[index];
+    }
+
+    for (unsigned int& target : remap) {
+        if (target == Unused)
+            target = next++;
+    }
+
+    return remap;
+}
+
+Report MeshOptimizer::optimize(std::vector<unsigned int>& indices, std::span<const Vector<3>> positions, std::vector<unsigned int>& remap,
+                               size_t cacheSize, float threshold) {
+    Report report{};
+    report.before = analyzeVertexCache(indices, positions.size(), cacheSize);
+
+    indices = optimizeVertexCache(indices, positions.size(), cacheSize);
+    indices = optimizeOverdraw(indices, positions, cacheSize, threshold);
+    remap = optimizeVertexFetch(indices, positions.size());
+
+    report.after = analyzeVertexCache(indices, positions.size(), cacheSize);
+    return report;
+}
@@ -1,162 +1,326 @@
 #include <model.h>
+#include <renderthread.h>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <unordered_map>
 
 using namespace BEG;
 
-Model::Model() : mVertices{} {}
+namespace {
+
+/* vertex counts up to this draw with 16-bit indices */
+constexpr size_t ShortIndexLimit{ 0x10000 };
+
+/* a packed vertex compared and hashed by its bits, so -0.0 and 0.0 stay apart and NaNs still match themselves */
+struct PackedVertex {
+    std::array<float, 9> values{};
+
+    bool operator==(const PackedVertex& other) const {
+        return std::memcmp(values.data(), other.values.data(), sizeof(values)) == 0;
+    }
+};
+
+struct PackedVertexHash {
+    size_t operator()(const PackedVertex& vertex) const {
+        size_t hash{ 0 };
+        for (float value : vertex.values) {
+            hash = (hash * 0x100000001b3u) ^ std::bit_cast<std::uint32_t>(value);
+        }
+        return hash;
+    }
+};
+
+void checkAttributes(const std::vector<Vector<3>>& vertices, const std::vector<Vector<3>>& normals,
+                     const std::vector<int>& colorIndices, const std::vector<Color>& colors) {
+    if (vertices.size() != colorIndices.size())
+        throw Model::ModelError::VerticesIndicesMismatchError;
+
+    if (vertices.size() != normals.size())
+        throw Model::ModelError::VerticesNormalsMismatchError;
+
+    for (int index : colorIndices) {
+        if (index < 0)
+            throw Model::ModelError::IndexOutOfRangeError;
+        if (index >= static_cast<int>(colors.size()))
+            throw Model::ModelError::TooFewColorsError;
+    }
+}
+
+PackedVertex pack(const Vector<3>& vertex, const Vector<3>& normal, const Color& color) {
+    return { {
+        vertex.x(), vertex.y(), vertex.z(),
+        normal.x(), normal.y(), normal.z(),
+        color.r(), color.g(), color.b()
+    } };
+}
+
+}
+
+Model::Model() : mVertices{}, mIndices{}, mBounds{}, mBoundingSphere{} {}
 
 Model::Model(const std::vector<Vector<3>>& vertices,
              const std::vector<Vector<3>>& normals,
              const std::vector<int>& colorIndices,
-             const std::vector<Color>& colors) : mVertices{} {
-    if (vertices.size() != colorIndices.size())
-        throw Model::ModelError::VerticesIndicesMismatchError;
-    
-    if (*std::max_element(std::begin(colorIndices), std::end(colorIndices)) >= static_cast<int>(colors.size()))
-        throw Model::ModelError::TooFewColorsError;
-
-    size_t index{ 0 };
-    for (auto vertex : vertices) {
-        mVertices.push_back(vertex.x());
-        mVertices.push_back(vertex.y());
-        mVertices.push_back(vertex.z());
-        mVertices.push_back(normals[index].x());
-        mVertices.push_back(normals[index].y());
-        mVertices.push_back(normals[index].z());
-        mVertices.push_back(colors[static_cast<size_t>(colorIndices[index])].r());
-        mVertices.push_back(colors[static_cast<size_t>(colorIndices[index])].g());
-        mVertices.push_back(colors[static_cast<size_t>(colorIndices[index])].b());
-
-        ++index;
+             const std::vector<Color>& colors) : mVertices{}, mIndices{}, mBounds{}, mBoundingSphere{} {
+    checkAttributes(vertices, normals, colorIndices, colors);
+
+    if (vertices.size() % 3 != 0)
+        throw Model::ModelError::IncompleteTriangleError;
+
+    std::unordered_map<PackedVertex, unsigned int, PackedVertexHash> unique{};
+    unique.reserve(vertices.size());
+    mIndices.reserve(vertices.size());
+
+    for (size_t i{ 0 }; i < vertices.size(); ++i) {
+        PackedVertex vertex{ pack(vertices[i], normals[i], colors[static_cast<size_t>(colorIndices[i])]) };
+        auto [it, inserted] = unique.try_emplace(vertex, static_cast<unsigned int>(unique.size()));
+
+        if (inserted)
+            mVertices.insert(mVertices.end(), vertex.values.begin(), vertex.values.end());
+
+        mIndices.push_back(it->second);
+    }
+
+    build();
+}
+
+Model::Model(const std::vector<Vector<3>>& vertices,
+             const std::vector<Vector<3>>& normals,
+             const std::vector<int>& colorIndices,
+             const std::vector<Color>& colors,
+             const std::vector<unsigned int>& indices) : mVertices{}, mIndices{ indices }, mBounds{}, mBoundingSphere{} {
+    checkAttributes(vertices, normals, colorIndices, colors);
+
+    if (indices.size() % 3 != 0)
+        throw Model::ModelError::IncompleteTriangleError;
+
+    if (std::any_of(indices.begin(), indices.end(), [&](unsigned int index) { return index >= vertices.size(); }))
+        throw Model::ModelError::IndexOutOfRangeError;
+
+    mVertices.reserve(vertices.size() * Stride);
+    for (size_t i{ 0 }; i < vertices.size(); ++i) {
+        PackedVertex vertex{ pack(vertices[i], normals[i], colors[static_cast<size_t>(colorIndices[i])]) };
+        mVertices.insert(mVertices.end(), vertex.values.begin(), vertex.values.end());
+    }
+
+    build();
+}
+
+void Model::build() {
+    size_t count{ vertexCount() };
+
+    if (count > 0) {
+        mBounds = AABB::empty();
+        for (size_t i{ 0 }; i < count; ++i) {
+            mBounds.merge({ mVertices[i * Stride], mVertices[(i * Stride) + 1], mVertices[(i * Stride) + 2] });
+        }
+
+        mBoundingSphere.center = mBounds.center();
+        for (size_t i{ 0 }; i < count; ++i) {
+            Vector<3> vertex{ mVertices[i * Stride], mVertices[(i * Stride) + 1], mVertices[(i * Stride) + 2] };
+            mBoundingSphere.radius = std::max(mBoundingSphere.radius, (vertex - mBoundingSphere.center).magnitude());
+        }
+    }
+
+    /* GL objects are created by whichever thread currently owns the context */
+    RenderThread::execute([this] {
+        glGenVertexArrays(1, &mVAO);
+        glGenBuffers(1, &mVBO);
+        glGenBuffers(1, &mEBO);
+
+        glBindVertexArray(mVAO);
+
+        /* the element buffer binding is recorded in the VAO */
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+        glBindVertexBuffer(Mesh::VertexBinding, mVBO, 0, Stride * sizeof(float));
+
+        for (unsigned int attribute{ 0 }; attribute < 3; ++attribute) {
+            glVertexAttribFormat(attribute, 3, GL_FLOAT, GL_FALSE, attribute * 3 * sizeof(float));
+            glVertexAttribBinding(attribute, Mesh::VertexBinding);
+            glEnableVertexAttribArray(attribute);
+        }
+
+        /* the instance buffer itself is bound by Mesh::bind */
+        auto instanceAttribute{ [](unsigned int location, int size, size_t offset) {
+            glVertexAttribFormat(location, size, GL_FLOAT, GL_FALSE, static_cast<unsigned int>(offset));
+            glVertexAttribBinding(location, Mesh::InstanceBinding);
+            glEnableVertexAttribArray(location);
+        } };
+
+        for (unsigned int column{ 0 }; column < 4; ++column) {
+            instanceAttribute(3 + column, 4, offsetof(InstanceData, model) + (column * 4 * sizeof(float)));
+        }
+        instanceAttribute(7, 3, offsetof(InstanceData, ambient));
+        instanceAttribute(8, 3, offsetof(InstanceData, diffuse));
+        instanceAttribute(9, 3, offsetof(InstanceData, specular));
+        instanceAttribute(10, 2, offsetof(InstanceData, shininess));
+
+        glVertexBindingDivisor(Mesh::InstanceBinding, 1);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    });
+
+    upload();
+}
+
+void Model::upload() {
+    /* 16-bit indices halve the element buffer whenever the vertex count allows it */
+    std::vector<std::uint16_t> shortIndices{};
+    if (vertexCount() <= ShortIndexLimit) {
+        shortIndices.assign(mIndices.begin(), mIndices.end());
     }
 
-    glGenVertexArrays(1, &mVAO);
-    glGenBuffers(1, &mVBO);
+    RenderThread::execute([this, &shortIndices] {
+        glBindVertexArray(mVAO);
 
-    glBindVertexArray(mVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mVertices.size() * sizeof(float)), mVertices.data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+        if (vertexCount() <= ShortIndexLimit)
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(shortIndices.size() * sizeof(std::uint16_t)), shortIndices.data(), GL_STATIC_DRAW);
+        else
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(mIndices.size() * sizeof(unsigned int)), mIndices.data(), GL_STATIC_DRAW);
 
-    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mVertices.size() * sizeof(float)), mVertices.data(), GL_STATIC_DRAW);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    });
+}
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+MeshOptimizer::Report Model::optimize(size_t cacheSize) {
+    std::vector<Vector<3>> positions(vertexCount());
+    for (size_t i{ 0 }; i < positions.size(); ++i) {
+        positions[i] = { mVertices[i * Stride], mVertices[(i * Stride) + 1], mVertices[(i * Stride) + 2] };
+    }
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    std::vector<unsigned int> remap{};
+    MeshOptimizer::Report report{ MeshOptimizer::optimize(mIndices, positions, remap, cacheSize) };
+    MeshOptimizer::remapVertices(mVertices, Stride, remap);
 
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    if (mVAO != 0)
+        upload();
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    return report;
 }
 
 Model::~Model() {
-    glDeleteVertexArrays(1, &mVAO);
-    glDeleteBuffers(1, &mVBO);
+    release();
 }
 
 Model& Model::operator=(Model &&model) {
+    if (this == &model)
+        return *this;
+
+    release();
+
     this->mVertices = std::move(model.mVertices);
+    this->mIndices = std::move(model.mIndices);
+    this->mBounds = model.mBounds;
+    this->mBoundingSphere = model.mBoundingSphere;
 
     this->mVAO = model.mVAO;
     this->mVBO = model.mVBO;
+    this->mEBO = model.mEBO;
 
     model.mVAO = 0;
-    model.mVAO = 0;
+    model.mVBO = 0;
+    model.mEBO = 0;
 
     return *this;
 }
 
+void Model::release() {
+    if (mVAO == 0 && mVBO == 0 && mEBO == 0)
+        return;
+
+    RenderThread::release([vao = mVAO, vbo = mVBO, ebo = mEBO] {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+    });
+
+    mVAO = 0;
+    mVBO = 0;
+    mEBO = 0;
+}
+
+namespace {
+
+/* cube geometry is fixed, so both tables are built at compile time */
+constexpr std::array<Vector<3>, 36> CubePositions{ {
+    { -1.0f, -1.0f, -1.0f },
+    {  1.0f, -1.0f, -1.0f },
+    {  1.0f,  1.0f, -1.0f },
+    {  1.0f,  1.0f, -1.0f },
+    { -1.0f,  1.0f, -1.0f },
+    { -1.0f, -1.0f, -1.0f },
+
+    { -1.0f, -1.0f,  1.0f },
+    {  1.0f, -1.0f,  1.0f },
+    {  1.0f,  1.0f,  1.0f },
+    {  1.0f,  1.0f,  1.0f },
+    { -1.0f,  1.0f,  1.0f },
+    { -1.0f, -1.0f,  1.0f },
+
+    { -1.0f,  1.0f,  1.0f },
+    { -1.0f,  1.0f, -1.0f },
+    { -1.0f, -1.0f, -1.0f },
+    { -1.0f, -1.0f, -1.0f },
+    { -1.0f, -1.0f,  1.0f },
+    { -1.0f,  1.0f,  1.0f },
+
+    {  1.0f,  1.0f,  1.0f },
+    {  1.0f,  1.0f, -1.0f },
+    {  1.0f, -1.0f, -1.0f },
+    {  1.0f, -1.0f, -1.0f },
+    {  1.0f, -1.0f,  1.0f },
+    {  1.0f,  1.0f,  1.0f },
+
+    { -1.0f, -1.0f, -1.0f },
+    {  1.0f, -1.0f, -1.0f },
+    {  1.0f, -1.0f,  1.0f },
+    {  1.0f, -1.0f,  1.0f },
+    { -1.0f, -1.0f,  1.0f },
+    { -1.0f, -1.0f, -1.0f },
+
+    { -1.0f,  1.0f, -1.0f },
+    {  1.0f,  1.0f, -1.0f },
+    {  1.0f,  1.0f,  1.0f },
+    {  1.0f,  1.0f,  1.0f },
+    { -1.0f,  1.0f,  1.0f },
+    { -1.0f,  1.0f, -1.0f }
+} };
+
+constexpr std::array<Vector<3>, 36> CubeNormals{ [] {
+    constexpr std::array<Vector<3>, 6> faces{ {
+        {  0.0f,  0.0f, -1.0f },
+        {  0.0f,  0.0f,  1.0f },
+        { -1.0f,  0.0f,  0.0f },
+        {  1.0f,  0.0f,  0.0f },
+        {  0.0f, -1.0f,  0.0f },
+        {  0.0f,  1.0f,  0.0f }
+    } };
+
+    std::array<Vector<3>, 36> normals{};
+    for (size_t i{ 0 }; i < normals.size(); ++i) {
+        normals[i] = faces[i / 6];
+    }
+
+    return normals;
+}() };
+
+}
+
 Model Model::cube(const std::vector<int>& colorIndices, const std::vector<Color>& colors) {
     return Model{
-        {
-            { -1.0f, -1.0f, -1.0f },
-            {  1.0f, -1.0f, -1.0f },
-            {  1.0f,  1.0f, -1.0f },
-            {  1.0f,  1.0f, -1.0f },
-            { -1.0f,  1.0f, -1.0f },
-            { -1.0f, -1.0f, -1.0f },
-
-            { -1.0f, -1.0f,  1.0f },
-            {  1.0f, -1.0f,  1.0f },
-            {  1.0f,  1.0f,  1.0f },
-            {  1.0f,  1.0f,  1.0f },
-            { -1.0f,  1.0f,  1.0f },
-            { -1.0f, -1.0f,  1.0f },
-
-            { -1.0f,  1.0f,  1.0f },
-            { -1.0f,  1.0f, -1.0f },
-            { -1.0f, -1.0f, -1.0f },
-            { -1.0f, -1.0f, -1.0f },
-            { -1.0f, -1.0f,  1.0f },
-            { -1.0f,  1.0f,  1.0f },
-
-            {  1.0f,  1.0f,  1.0f },
-            {  1.0f,  1.0f, -1.0f },
-            {  1.0f, -1.0f, -1.0f },
-            {  1.0f, -1.0f, -1.0f },
-            {  1.0f, -1.0f,  1.0f },
-            {  1.0f,  1.0f,  1.0f },
-
-            { -1.0f, -1.0f, -1.0f },
-            {  1.0f, -1.0f, -1.0f },
-            {  1.0f, -1.0f,  1.0f },
-            {  1.0f, -1.0f,  1.0f },
-            { -1.0f, -1.0f,  1.0f },
-            { -1.0f, -1.0f, -1.0f },
-     
-            { -1.0f,  1.0f, -1.0f },
-            {  1.0f,  1.0f, -1.0f },
-            {  1.0f,  1.0f,  1.0f },
-            {  1.0f,  1.0f,  1.0f },
-            { -1.0f,  1.0f,  1.0f },
-            { -1.0f,  1.0f, -1.0f },
-        },
-        {
-            {  0.0f,  0.0f, -1.0f },
-            {  0.0f,  0.0f, -1.0f }, 
-            {  0.0f,  0.0f, -1.0f }, 
-            {  0.0f,  0.0f, -1.0f }, 
-            {  0.0f,  0.0f, -1.0f }, 
-            {  0.0f,  0.0f, -1.0f }, 
-
-            {  0.0f,  0.0f,  1.0f },
-            {  0.0f,  0.0f,  1.0f },
-            {  0.0f,  0.0f,  1.0f },
-            {  0.0f,  0.0f,  1.0f },
-            {  0.0f,  0.0f,  1.0f },
-            {  0.0f,  0.0f,  1.0f },
-
-            { -1.0f,  0.0f,  0.0f },
-            { -1.0f,  0.0f,  0.0f },
-            { -1.0f,  0.0f,  0.0f },
-            { -1.0f,  0.0f,  0.0f },
-            { -1.0f,  0.0f,  0.0f },
-            { -1.0f,  0.0f,  0.0f },
-
-            {  1.0f,  0.0f,  0.0f },
-            {  1.0f,  0.0f,  0.0f },
-            {  1.0f,  0.0f,  0.0f },
-            {  1.0f,  0.0f,  0.0f },
-            {  1.0f,  0.0f,  0.0f },
-            {  1.0f,  0.0f,  0.0f },
-
-            {  0.0f, -1.0f,  0.0f },
-            {  0.0f, -1.0f,  0.0f },
-            {  0.0f, -1.0f,  0.0f },
-            {  0.0f, -1.0f,  0.0f },
-            {  0.0f, -1.0f,  0.0f },
-            {  0.0f, -1.0f,  0.0f },
-
-            {  0.0f,  1.0f,  0.0f },
-            {  0.0f,  1.0f,  0.0f },
-            {  0.0f,  1.0f,  0.0f },
-            {  0.0f,  1.0f,  0.0f },
-            {  0.0f,  1.0f,  0.0f },
-            {  0.0f,  1.0f,  0.0f }
-        },
+        std::vector<Vector<3>>(CubePositions.begin(), CubePositions.end()),
+        std::vector<Vector<3>>(CubeNormals.begin(), CubeNormals.end()),
         colorIndices,
         colors
     };
@@ -166,7 +330,44 @@ Model Model::cube(const Color& color) {
     return Model::cube(std::vector<int>(36, 0), { color });
 }
 
-void Model::render() {
-    glBindVertexArray(mVAO);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<int>(mVertices.size() / 6));
-}
\ No newline at end of file
+InstanceData::InstanceData(const Matrix<4>& transform, const Material& material, bool isLightable)
+    : model{ transform },
+      ambient{ material.ambient.r(), material.ambient.g(), material.ambient.b() },
+      diffuse{ material.diffuse.r(), material.diffuse.g(), material.diffuse.b() },
+      specular{ material.specular.r(), material.specular.g(), material.specular.b() },
+      shininess{ material.shininess },
+      lightable{ isLightable ? 1.0f : 0.0f } {}
+
+void Mesh::bind(unsigned int instanceBuffer) const {
+    glBindVertexArray(vao);
+    glBindVertexBuffer(InstanceBinding, instanceBuffer, 0, sizeof(InstanceData));
+}
+
+void Mesh::draw(unsigned int first, int instances) const {
+    /* the base instance offsets the instance attributes only, so one buffer binding serves every batch */
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, count, indexType, nullptr, instances, first);
+}
+
+size_t Model::vertexCount() const {
+    return mVertices.size() / Stride;
+}
+
+size_t Model::indexCount() const {
+    return mIndices.size();
+}
+
+Mesh Model::mesh() const {
+    return {
+        mVAO,
+        static_cast<int>(mIndices.size()),
+        static_cast<unsigned int>(vertexCount() <= ShortIndexLimit ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT)
+    };
+}
+
+const AABB& Model::bounds() const {
+    return mBounds;
+}
+
+const Sphere& Model::boundingSphere() const {
+    return mBoundingSphere;
+}
@@ -0,0 +1,146 @@
+#include <perfcounters.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace BEG;
+
+namespace {
+
+struct CounterGroup {
+    bool opened{ false };
+
+    int leader{ -1 };
+    std::array<int, PerfCounters::CounterCount> fds{};
+
+    /* position of each counter in a group read, or -1 if it could not be opened */
+    std::array<int, PerfCounters::CounterCount> slots{};
+    int size{ 0 };
+
+    CounterGroup() {
+        fds.fill(-1);
+        slots.fill(-1);
+    }
+
+    CounterGroup(const CounterGroup&) = delete;
+    CounterGroup& operator=(const CounterGroup&) = delete;
+
+    ~CounterGroup() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd != -1)
+                close(fd);
+        }
+#endif
+    }
+
+    void open();
+};
+
+#ifdef __linux__
+int openCounter(std::uint32_t type, std::uint64_t config, int groupFd) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.disabled = groupFd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+constexpr std::uint64_t cacheMiss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+#endif
+
+void CounterGroup::open() {
+    opened = true;
+
+#ifdef __linux__
+    const std::array<std::pair<std::uint32_t, std::uint64_t>, PerfCounters::CounterCount> configs{ {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D) },
+        { PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+    } };
+
+    for (size_t i{ 0 }; i < configs.size(); ++i) {
+        int fd{ openCounter(configs[i].first, configs[i].second, leader) };
+        if (fd == -1)
+            continue;
+
+        if (leader == -1)
+            leader = fd;
+
+        fds[i] = fd;
+        slots[i] = size++;
+    }
+
+    if (leader != -1) {
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+thread_local CounterGroup tGroup{};
+
+CounterGroup& currentGroup() {
+    if (!tGroup.opened)
+        tGroup.open();
+
+    return tGroup;
+}
+
+}
+
+std::atomic<bool> PerfCounters::sEnabled{ false };
+
+const char* PerfCounters::name(Counter counter) {
+    switch (counter) {
+        case Counter::Cycles: return "cycles";
+        case Counter::Instructions: return "instructions";
+        case Counter::L1DMisses: return "l1d_misses";
+        case Counter::LLCMisses: return "llc_misses";
+        case Counter::BranchMisses: return "branch_misses";
+        default: return "unknown";
+    }
+}
+
+void PerfCounters::enable(bool value) {
+    sEnabled.store(value, std::memory_order_relaxed);
+}
+
+bool PerfCounters::available(Counter counter) {
+    return currentGroup().slots[static_cast<size_t>(counter)] != -1;
+}
+
+PerfCounters::Values PerfCounters::read() {
+    Values values{};
+
+#ifdef __linux__
+    CounterGroup& group{ currentGroup() };
+    if (group.leader == -1)
+        return values;
+
+    /* PERF_FORMAT_GROUP layout: the number of counters followed by their values */
+    std::array<std::uint64_t, CounterCount + 1> buffer{};
+    if (::read(group.leader, buffer.data(), sizeof(buffer)) <= 0)
+        return values;
+
+    for (size_t i{ 0 }; i < CounterCount; ++i) {
+        if (group.slots[i] != -1)
+            values[i] = buffer[static_cast<size_t>(group.slots[i]) + 1];
+    }
+#endif
+
+    return values;
+}
@@ -0,0 +1,252 @@
+#include <profiler.h>
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace BEG;
+
+namespace {
+
+/* fields are relaxed atomics so a dump can read a ring while its thread keeps writing */
+struct Event {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<std::uint64_t> start{}, end{};
+};
+
+struct ThreadTrace {
+    const char* name{ nullptr };
+    unsigned long id{};
+
+    std::array<Event, Profiler::EventsPerThread> events{};
+    std::atomic<size_t> written{ 0 };
+};
+
+struct Registry {
+    std::mutex mutex{};
+    std::vector<std::unique_ptr<ThreadTrace>> threads{};
+    std::deque<std::string> names{};
+
+    std::array<std::atomic<std::uint64_t>, Profiler::MaxFrames> frameStarts{};
+    std::atomic<size_t> frames{ 0 };
+
+    /* checked every frame without the mutex, path and frame count are guarded by it */
+    std::atomic<bool> dumpRequested{ false };
+    std::string dumpPath{};
+    size_t dumpFrames{};
+
+    /* reference points used to convert raw ticks to nanoseconds */
+    std::uint64_t epochTicks{ Profiler::now() };
+    std::chrono::steady_clock::time_point epochTime{ std::chrono::steady_clock::now() };
+};
+
+Registry& registry() {
+    static Registry instance{};
+    return instance;
+}
+
+thread_local ThreadTrace* tTrace{ nullptr };
+
+ThreadTrace& currentTrace() {
+    if (tTrace == nullptr) {
+        Registry& reg{ registry() };
+        std::lock_guard<std::mutex> lock{ reg.mutex };
+
+        reg.threads.push_back(std::make_unique<ThreadTrace>());
+        tTrace = reg.threads.back().get();
+        tTrace->id = reg.threads.size();
+    }
+
+    return *tTrace;
+}
+
+struct ExportedEvent {
+    const char* name{};
+    std::uint64_t start{}, end{};
+};
+
+void writeEscaped(std::ofstream& out, const char* str) {
+    for (; *str != '\0'; ++str) {
+        if (*str == '"' || *str == '\\')
+            out << '\\';
+        out << *str;
+    }
+}
+
+}
+
+#ifdef BEG_PROFILE
+std::atomic<bool> Profiler::sEnabled{ true };
+#else
+std::atomic<bool> Profiler::sEnabled{ false };
+#endif
+
+void Profiler::enable(bool value) {
+    sEnabled.store(value, std::memory_order_relaxed);
+}
+
+double Profiler::ticksToNanoseconds(std::uint64_t ticks) {
+#if defined(__x86_64__) || defined(__i386__)
+    Registry& reg{ registry() };
+
+    double elapsedTicks{ static_cast<double>(now() - reg.epochTicks) };
+    double elapsedNs{ static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - reg.epochTime).count()) };
+
+    if (elapsedTicks <= 0.0)
+        return 0.0;
+
+    return static_cast<double>(ticks) * (elapsedNs / elapsedTicks);
+#else
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::duration(static_cast<std::chrono::steady_clock::rep>(ticks))).count());
+#endif
+}
+
+void Profiler::nameThread(const char* name) {
+    currentTrace().name = name;
+}
+
+void Profiler::record(const char* name, std::uint64_t start, std::uint64_t end) {
+    ThreadTrace& trace{ currentTrace() };
+
+    size_t index{ trace.written.load(std::memory_order_relaxed) };
+    Event& event{ trace.events[index & (EventsPerThread - 1)] };
+
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+
+    trace.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::frame() {
+    Registry& reg{ registry() };
+
+    size_t frame{ reg.frames.load(std::memory_order_relaxed) };
+    reg.frameStarts[frame % MaxFrames].store(now(), std::memory_order_relaxed);
+    reg.frames.store(frame + 1, std::memory_order_release);
+
+    if (!reg.dumpRequested.load(std::memory_order_acquire))
+        return;
+
+    std::string path{};
+    size_t frames{};
+    {
+        std::lock_guard<std::mutex> lock{ reg.mutex };
+        if (!reg.dumpRequested.exchange(false, std::memory_order_relaxed))
+            return;
+
+        path = reg.dumpPath;
+        frames = reg.dumpFrames;
+    }
+
+    dump(path, frames);
+}
+
+void Profiler::requestDump(const std::string& path, size_t frames) {
+    Registry& reg{ registry() };
+    std::lock_guard<std::mutex> lock{ reg.mutex };
+
+    reg.dumpPath = path;
+    reg.dumpFrames = frames;
+    reg.dumpRequested.store(true, std::memory_order_release);
+}
+
+bool Profiler::dump(const std::string& path, size_t frames) {
+    Registry& reg{ registry() };
+
+    /* only events that started inside the requested frame window are exported */
+    size_t frameCount{ reg.frames.load(std::memory_order_acquire) };
+    size_t window{ std::min({ frames, frameCount, MaxFrames - 1 }) };
+    std::uint64_t cutoff{ window > 0 ? reg.frameStarts[(frameCount - window) % MaxFrames].load(std::memory_order_relaxed) : 0 };
+
+    std::ofstream out{ path };
+    if (!out)
+        return false;
+
+    double nsPerTick{ ticksToNanoseconds(1 << 20) / static_cast<double>(1 << 20) };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first{ true };
+
+    std::lock_guard<std::mutex> lock{ reg.mutex };
+    for (const auto& trace : reg.threads) {
+        if (!first)
+            out << ',';
+        first = false;
+
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->id << ",\"args\":{\"name\":\"";
+        if (trace->name != nullptr)
+            writeEscaped(out, trace->name);
+        else
+            out << "thread " << trace->id;
+        out << "\"}}";
+
+        size_t written{ trace->written.load(std::memory_order_acquire) };
+        size_t begin{ written > EventsPerThread ? written - EventsPerThread : 0 };
+
+        std::vector<ExportedEvent> events{};
+        events.reserve(written - begin);
+        for (size_t i{ begin }; i < written; ++i) {
+            const Event& event{ trace->events[i & (EventsPerThread - 1)] };
+            events.push_back({
+                event.name.load(std::memory_order_relaxed),
+                event.start.load(std::memory_order_relaxed),
+                event.end.load(std::memory_order_relaxed)
+            });
+        }
+
+        /* drop whatever the owning thread overwrote while we were copying */
+        size_t after{ trace->written.load(std::memory_order_acquire) };
+        size_t valid{ after > EventsPerThread ? after - EventsPerThread : 0 };
+        size_t skip{ valid > begin ? std::min(valid - begin, events.size()) : 0 };
+
+        for (size_t i{ skip }; i < events.size(); ++i) {
+            const ExportedEvent& event{ events[i] };
+            if (event.name == nullptr || event.start < cutoff || event.start < reg.epochTicks)
+                continue;
+
+            double ts{ static_cast<double>(event.start - reg.epochTicks) * nsPerTick / 1000.0 };
+            double dur{ static_cast<double>(event.end - event.start) * nsPerTick / 1000.0 };
+
+            out << ",{\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace->id << ",\"ts\":" << ts << ",\"dur\":" << dur << '}';
+        }
+    }
+
+    out << "]}\n";
+
+    return static_cast<bool>(out);
+}
+
+const char* Profiler::intern(const std::string& name) {
+    Registry& reg{ registry() };
+    std::lock_guard<std::mutex> lock{ reg.mutex };
+
+    auto it{ std::find(reg.names.begin(), reg.names.end(), name) };
+    if (it != reg.names.end())
+        return it->c_str();
+
+    reg.names.push_back(name);
+    return reg.names.back().c_str();
+}
+
+std::string Profiler::demangle(const char* name) {
+    int status{};
+    char* demangled{ abi::__cxa_demangle(name, nullptr, nullptr, &status) };
+
+    if (status != 0 || demangled == nullptr)
+        return name;
+
+    std::string result{ demangled };
+    std::free(demangled);
+
+    return result;
+}
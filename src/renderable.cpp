@@ -1,64 +1,230 @@
 #include <renderable.h>
+#include <jobs.h>
+
+#include <algorithm>
+#include <bit>
 
 using namespace BEG;
 
+namespace {
+
+/* refreshing bounds builds a matrix per moved entity, worth spreading over the pool well before the plane tests alone are */
+constexpr size_t ParallelThreshold{ 2048 };
+
+}
+
+bool WorldBounds::update(const Transform& transform, const AABB& local) {
+    if (mValid && transform.position == mPosition && transform.orientation == mOrientation && transform.scale == mScale
+        && local.min == mLocal.min && local.max == mLocal.max)
+        return false;
+
+    /* rotated and scaled about the entity's own position, which is then added back at full precision */
+    AABB offset{ local.transformed(transform.toMatrix(transform.position)) };
+    mCenter = transform.position + Position(offset.center());
+    mExtents = offset.extents();
+
+    mPosition = transform.position;
+    mOrientation = transform.orientation;
+    mScale = transform.scale;
+    mLocal = local;
+    mValid = true;
+
+    return true;
+}
+
+const Position& WorldBounds::center() const {
+    return mCenter;
+}
+
+const Vector<3>& WorldBounds::extents() const {
+    return mExtents;
+}
+
+void RenderSystem::collectViews(Game& game) {
+    mSources.clear();
+
+    if (game.viewport.z() > 0.0f && game.viewport.w() > 0.0f)
+        mSources.push_back({ &game.camera, game.viewport, nullptr, 0 });
+
+    for (auto [view] : game.scene.view<CameraView>()) {
+        if (view.active && view.viewport.z() > 0.0f && view.viewport.w() > 0.0f)
+            mSources.push_back({ &view.camera, view.viewport, view.target, view.order });
+    }
+
+    std::stable_sort(mSources.begin(), mSources.end(), [](const Source& a, const Source& b) {
+        if ((a.target != nullptr) != (b.target != nullptr))
+            return a.target != nullptr;
+        return a.order < b.order;
+    });
+}
+
 void RenderSystem::updateAll(Game& game, std::vector<std::tuple<Transform&, Renderable&>> view) {
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    FrameSnapshot& snapshot{ game.snapshot() };
+    snapshot.clear();
 
-    for (auto [transform, renderable] : view) {
-        renderable.shader.use();
+    /* everything is drawn relative to the main camera, so float precision is spent near the viewer and not near the world origin */
+    const Position& origin{ game.camera.position() };
 
-        renderable.shader.setUniform("model", transform.toMatrix());
-        renderable.shader.setUniform("combined", game.camera.combinedMatrix(game.aspectRatio(), 0.1f, 100.0f));
+    collectViews(game);
+    snapshot.views.resize(mSources.size());
+    mFrusta.resize(mSources.size());
 
-        renderable.shader.setUniform("viewPosition", game.camera.position);
+    for (size_t v{ 0 }; v < mSources.size(); ++v) {
+        const Source& source{ mSources[v] };
+        ViewState& state{ snapshot.views[v] };
 
-        renderable.shader.setUniform("lightable", renderable.lightable);
+        int targetWidth{ source.target != nullptr ? source.target->width() : game.windowWidth() };
+        int targetHeight{ source.target != nullptr ? source.target->height() : game.windowHeight() };
 
-        if (renderable.lightable) {
-            renderable.shader.setUniform("material.ambient", Vector<3>{ renderable.material.ambient.r(), renderable.material.ambient.g(), renderable.material.ambient.b() });
-            renderable.shader.setUniform("material.diffuse", Vector<3>{ renderable.material.diffuse.r(), renderable.material.diffuse.g(), renderable.material.diffuse.b() });
-            renderable.shader.setUniform("material.specular", Vector<3>{ renderable.material.specular.r(), renderable.material.specular.g(), renderable.material.specular.b() });
-            renderable.shader.setUniform("material.shininess", renderable.material.shininess);
+        state.target = source.target;
+        state.x = static_cast<int>(source.viewport.x() * static_cast<float>(targetWidth));
+        state.y = static_cast<int>(source.viewport.y() * static_cast<float>(targetHeight));
+        state.width = std::max(static_cast<int>(source.viewport.z() * static_cast<float>(targetWidth)), 1);
+        state.height = std::max(static_cast<int>(source.viewport.w() * static_cast<float>(targetHeight)), 1);
 
-            auto directionalLightView{ game.scene.view<DirectionalLight>() };
-            renderable.shader.setUniform("numberOfDirectionalLights", static_cast<int>(directionalLightView.size()));
+        Camera& camera{ *source.camera };
+        camera.aspect(static_cast<float>(state.width) / static_cast<float>(state.height));
 
-            for (size_t i{ 0 }; i < directionalLightView.size(); ++i) {
-                auto [light] = directionalLightView[i];
-                
-                renderable.shader.setArrayUniform("directionalLights", "direction", i, -light.direction.normalized());
-                renderable.shader.setArrayUniform("directionalLights", "color", i, light.color.toVector());
-                renderable.shader.setArrayUniform("directionalLights", "ambientStrength", i, light.ambientStrength);
-            }
+        /* the view's matrices expect positions relative to its own camera, this moves the main camera's origin there */
+        Vector<3> offset{ camera.relative(origin) };
+        Matrix<4> combined{ camera.viewProjectionMatrix() * Affine::translation(offset) };
 
-            auto pointLightView{ game.scene.view<Transform, PointLight>() };
-            renderable.shader.setUniform("numberOfPointLights", static_cast<int>(pointLightView.size()));
+        state.combined = combined;
+        state.viewPosition = -offset;
+        state.depthMode = camera.depthMode();
+        mFrusta[v] = Frustum::fromMatrix(combined, camera.clipDepth());
+    }
 
-            for (size_t i{ 0 }; i < pointLightView.size(); ++i) {
-                auto [transform, light] = pointLightView[i];
-                
-                renderable.shader.setArrayUniform("pointLights", "position", i, transform.position);
-                renderable.shader.setArrayUniform("pointLights", "color", i, light.color.toVector());
-                renderable.shader.setArrayUniform("pointLights", "radius", i, light.radius);
-                renderable.shader.setArrayUniform("pointLights", "ambientStrength", i, light.ambientStrength);
-            }
+    for (auto [light] : game.scene.view<DirectionalLight>()) {
+        snapshot.directionalLights.push_back({ -light.direction.normalized(), light.color.toVector(), light.ambientStrength });
+    }
+
+    for (auto [transform, light] : game.scene.view<Transform, PointLight>()) {
+        snapshot.pointLights.push_back({ game.camera.relative(transform.position), light.color.toVector(), light.radius, light.ambientStrength });
+    }
+
+    for (auto [transform, light] : game.scene.view<Transform, SpotLight>()) {
+        snapshot.spotLights.push_back({
+            game.camera.relative(transform.position),
+            transform.orientation.rotate({ 0.0f, 0.0f, -1.0f }),
+            light.color.toVector(),
+            light.range,
+            light.angle,
+            light.blurAngle
+        });
+    }
+
+    size_t count{ view.size() }, words{ maskWords(count) }, views{ mSources.size() };
+    mCenterX.resize(count);
+    mCenterY.resize(count);
+    mCenterZ.resize(count);
+    mExtentX.resize(count);
+    mExtentY.resize(count);
+    mExtentZ.resize(count);
+    mVisible.resize(words * views);
 
-            auto spotLightView{ game.scene.view<Transform, SpotLight>() };
-            renderable.shader.setUniform("numberOfSpotLights", static_cast<int>(spotLightView.size()));
-            for (size_t i{ 0 }; i < spotLightView.size(); ++i) {
-                auto [transform, light] = spotLightView[i];
-
-                renderable.shader.setArrayUniform("spotLights", "position", i, transform.position);
-                renderable.shader.setArrayUniform("spotLights", "direction", i, Vector<3>(transform.orientation.toMatrix() * Vector<4>(0.0f, 0.0f, -1.0f, 1.0f)));
-                renderable.shader.setArrayUniform("spotLights", "color", i, light.color.toVector());
-                renderable.shader.setArrayUniform("spotLights", "range", i, light.range);
-                renderable.shader.setArrayUniform("spotLights", "angle", i, light.angle);
-                renderable.shader.setArrayUniform("spotLights", "blurAngle", i, light.blurAngle);
+    /*
+     * Chunks are whole mask words, so every chunk refreshes its own entities'
+     * bounds and writes its own words of each view's mask without
+     * synchronisation, and the views test the chunk while it is still in cache.
+     */
+    auto cull{ [&](size_t firstWord, size_t lastWord) {
+        size_t begin{ firstWord * 64 }, end{ std::min(lastWord * 64, count) };
+
+        for (size_t i{ begin }; i < end; ++i) {
+            auto& [transform, renderable] = view[i];
+            renderable.bounds.update(transform, renderable.model.bounds());
+
+            Vector<3> center{ game.camera.relative(renderable.bounds.center()) };
+            const Vector<3>& extents{ renderable.bounds.extents() };
+            mCenterX[i] = center.x();
+            mCenterY[i] = center.y();
+            mCenterZ[i] = center.z();
+            mExtentX[i] = extents.x();
+            mExtentY[i] = extents.y();
+            mExtentZ[i] = extents.z();
+        }
+
+        size_t length{ end - begin };
+        AABBSoA boxes{
+            std::span<const float>(mCenterX).subspan(begin, length),
+            std::span<const float>(mCenterY).subspan(begin, length),
+            std::span<const float>(mCenterZ).subspan(begin, length),
+            std::span<const float>(mExtentX).subspan(begin, length),
+            std::span<const float>(mExtentY).subspan(begin, length),
+            std::span<const float>(mExtentZ).subspan(begin, length)
+        };
+
+        for (size_t v{ 0 }; v < views; ++v) {
+            mFrusta[v].test(boxes, std::span<std::uint64_t>(mVisible).subspan((v * words) + firstWord, lastWord - firstWord));
+        }
+    } };
+
+    if (count < ParallelThreshold)
+        cull(0, words);
+    else
+        JobPool::shared().parallelFor(words, ParallelThreshold / 256, cull);
+
+    /* walk the union of the masks, so entities no view sees cost nothing and the rest are recorded once */
+    snapshot.draws.reserve(count);
+    mDrawEntities.clear();
+    for (size_t w{ 0 }; w < words; ++w) {
+        std::uint64_t seen{ 0 };
+        for (size_t v{ 0 }; v < views; ++v) {
+            seen |= mVisible[(v * words) + w];
+        }
+
+        while (seen != 0) {
+            size_t bit{ static_cast<size_t>(std::countr_zero(seen)) };
+            seen &= seen - 1;
+
+            auto& [transform, renderable] = view[(w * 64) + bit];
+            std::uint32_t index{ static_cast<std::uint32_t>(snapshot.draws.size()) };
+            mDrawEntities.push_back(static_cast<std::uint32_t>((w * 64) + bit));
+            snapshot.draws.push_back({
+                { transform.toMatrix(origin), renderable.material, renderable.lightable },
+                renderable.model.mesh(),
+                renderable.shader.id()
+            });
+
+            for (size_t v{ 0 }; v < views; ++v) {
+                if ((mVisible[(v * words) + w] >> bit) & 1u)
+                    snapshot.views[v].draws.push_back(index);
             }
         }
+    }
+
+    /* each view's draws in key order: by pass, shader and mesh, front to back within those, one instanced draw per state run */
+    for (size_t v{ 0 }; v < views; ++v) {
+        ViewState& state{ snapshot.views[v] };
+        Vector<3> front{ mSources[v].camera->front() };
+
+        mPackets.clear();
+        for (std::uint32_t index : state.draws) {
+            const DrawItem& item{ snapshot.draws[index] };
+            size_t entity{ mDrawEntities[index] };
+            const Renderable& renderable{ std::get<Renderable&>(view[entity]) };
+
+            Vector<3> center{ mCenterX[entity], mCenterY[entity], mCenterZ[entity] };
+            float depth{ (center - state.viewPosition).dot(front) };
+
+            mPackets.push_back({ RenderQueue::makeKey(renderable.pass, item.shader, item.mesh.vao, depth), index });
+        }
 
-        renderable.model.render();
+        RenderQueue::sort(mPackets, mScratch);
+
+        for (std::uint32_t i{ 0 }; i < mPackets.size(); ++i) {
+            const RenderQueue::Packet& packet{ mPackets[i] };
+            const DrawItem& item{ snapshot.draws[packet.draw] };
+            state.draws[i] = packet.draw;
+
+            bool cut{ i == 0 || RenderQueue::stateOf(packet.key) != RenderQueue::stateOf(mPackets[i - 1].key) };
+            cut = cut || item.shader != state.batches.back().shader || item.mesh.vao != state.batches.back().mesh.vao;
+
+            if (cut)
+                state.batches.push_back({ item.mesh, item.shader, i, 0 });
+
+            ++state.batches.back().count;
+        }
     }
-}
\ No newline at end of file
+}
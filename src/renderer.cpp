@@ -0,0 +1,155 @@
+#include <renderer.h>
+#include <renderthread.h>
+
+#include <algorithm>
+
+using namespace BEG;
+
+Renderer::~Renderer() {
+    if (mInstanceBuffer == 0)
+        return;
+
+    RenderThread::release([buffer = mInstanceBuffer] {
+        glDeleteBuffers(1, &buffer);
+    });
+}
+
+void Renderer::applyDepthMode(Camera::DepthMode mode) {
+    if (mDepthMode == mode)
+        return;
+
+    if (mode == Camera::DepthMode::ReverseInfinite) {
+        /* near maps to 1 and infinity to 0, the 0..1 range keeps float depth's precision near 0 where it is needed */
+        glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+        glDepthFunc(GL_GREATER);
+        glClearDepth(0.0);
+    } else {
+        glClipControl(GL_LOWER_LEFT, GL_NEGATIVE_ONE_TO_ONE);
+        glDepthFunc(GL_LEQUAL);
+        glClearDepth(1.0);
+    }
+
+    mDepthMode = mode;
+}
+
+void Renderer::setViewUniforms(const FrameSnapshot& frame, const ViewState& view, unsigned int shader) {
+    Shader::setUniform(shader, "combined", view.combined);
+    Shader::setUniform(shader, "viewPosition", view.viewPosition);
+
+    Shader::setUniform(shader, "numberOfDirectionalLights", static_cast<int>(frame.directionalLights.size()));
+    for (size_t i{ 0 }; i < frame.directionalLights.size(); ++i) {
+        const DirectionalLightState& light{ frame.directionalLights[i] };
+
+        Shader::setArrayUniform(shader, "directionalLights", "direction", i, light.direction);
+        Shader::setArrayUniform(shader, "directionalLights", "color", i, light.color);
+        Shader::setArrayUniform(shader, "directionalLights", "ambientStrength", i, light.ambientStrength);
+    }
+
+    Shader::setUniform(shader, "numberOfPointLights", static_cast<int>(frame.pointLights.size()));
+    for (size_t i{ 0 }; i < frame.pointLights.size(); ++i) {
+        const PointLightState& light{ frame.pointLights[i] };
+
+        Shader::setArrayUniform(shader, "pointLights", "position", i, light.position);
+        Shader::setArrayUniform(shader, "pointLights", "color", i, light.color);
+        Shader::setArrayUniform(shader, "pointLights", "radius", i, light.radius);
+        Shader::setArrayUniform(shader, "pointLights", "ambientStrength", i, light.ambientStrength);
+    }
+
+    Shader::setUniform(shader, "numberOfSpotLights", static_cast<int>(frame.spotLights.size()));
+    for (size_t i{ 0 }; i < frame.spotLights.size(); ++i) {
+        const SpotLightState& light{ frame.spotLights[i] };
+
+        Shader::setArrayUniform(shader, "spotLights", "position", i, light.position);
+        Shader::setArrayUniform(shader, "spotLights", "direction", i, light.direction);
+        Shader::setArrayUniform(shader, "spotLights", "color", i, light.color);
+        Shader::setArrayUniform(shader, "spotLights", "range", i, light.range);
+        Shader::setArrayUniform(shader, "spotLights", "angle", i, light.angle);
+        Shader::setArrayUniform(shader, "spotLights", "blurAngle", i, light.blurAngle);
+    }
+}
+
+void Renderer::uploadInstances(const FrameSnapshot& frame) {
+    mInstances.clear();
+    mViewBases.clear();
+
+    for (const ViewState& view : frame.views) {
+        mViewBases.push_back(mInstances.size());
+
+        for (std::uint32_t index : view.draws) {
+            mInstances.push_back(frame.draws[index].instance);
+        }
+    }
+
+    if (mInstanceBuffer == 0)
+        glGenBuffers(1, &mInstanceBuffer);
+
+    /* respecified every frame, so the driver can hand out fresh storage instead of waiting on the previous frame's draws */
+    glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mInstances.size() * sizeof(InstanceData)), mInstances.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::draw(const FrameSnapshot& frame) {
+    uploadInstances(frame);
+
+    /* views sharing the window share one depth buffer, so one reverse-Z view moves them all to the float one */
+    bool offscreen{ std::any_of(frame.views.begin(), frame.views.end(), [](const ViewState& view) {
+        return view.target == nullptr && view.depthMode == Camera::DepthMode::ReverseInfinite;
+    }) };
+
+    if (offscreen) {
+        mTarget.resize(frame.width, frame.height);
+        mTarget.bind();
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(0, 0, frame.width, frame.height);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    /* each view clears only its own rectangle, with the depth value its mode wants */
+    glEnable(GL_SCISSOR_TEST);
+
+    for (size_t v{ 0 }; v < frame.views.size(); ++v) {
+        const ViewState& view{ frame.views[v] };
+
+        if (view.target != nullptr)
+            view.target->bind();
+        else if (offscreen)
+            mTarget.bind();
+        else
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        applyDepthMode(view.depthMode);
+
+        glViewport(view.x, view.y, view.width, view.height);
+        glScissor(view.x, view.y, view.width, view.height);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        /* batches arrive in RenderQueue key order, so state only changes where the key does */
+        unsigned int program{ 0 };
+        unsigned int vao{ 0 };
+
+        for (const DrawBatch& batch : view.batches) {
+            if (batch.shader != program) {
+                program = batch.shader;
+                Shader::use(program);
+                setViewUniforms(frame, view, program);
+            }
+
+            if (batch.mesh.vao != vao) {
+                vao = batch.mesh.vao;
+                batch.mesh.bind(mInstanceBuffer);
+            }
+
+            batch.mesh.draw(static_cast<unsigned int>(mViewBases[v]) + batch.first, static_cast<int>(batch.count));
+        }
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+
+    if (offscreen)
+        mTarget.blitToScreen();
+}
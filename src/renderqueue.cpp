@@ -0,0 +1,50 @@
+#include <renderqueue.h>
+
+#include <array>
+#include <cstddef>
+
+using namespace BEG;
+
+void RenderQueue::sort(std::vector<Packet>& packets, std::vector<Packet>& scratch) {
+    constexpr size_t Digits{ sizeof(std::uint64_t) };
+
+    size_t count{ packets.size() };
+    if (count < 2)
+        return;
+
+    /* every byte's histogram in one read of the keys */
+    std::array<std::array<std::uint32_t, 256>, Digits> histograms{};
+    for (const Packet& packet : packets) {
+        for (size_t digit{ 0 }; digit < Digits; ++digit) {
+            ++histograms[digit][(packet.key >> (digit * 8)) & 0xFF];
+        }
+    }
+
+    scratch.resize(count);
+    Packet* from{ packets.data() };
+    Packet* to{ scratch.data() };
+
+    for (size_t digit{ 0 }; digit < Digits; ++digit) {
+        std::array<std::uint32_t, 256>& histogram{ histograms[digit] };
+
+        /* a byte every key shares would leave the order as it is */
+        if (histogram[(from[0].key >> (digit * 8)) & 0xFF] == count)
+            continue;
+
+        std::uint32_t offset{ 0 };
+        for (std::uint32_t& bucket : histogram) {
+            std::uint32_t size{ bucket };
+            bucket = offset;
+            offset += size;
+        }
+
+        for (size_t i{ 0 }; i < count; ++i) {
+            to[histogram[(from[i].key >> (digit * 8)) & 0xFF]++] = from[i];
+        }
+
+        std::swap(from, to);
+    }
+
+    if (from != packets.data())
+        packets.swap(scratch);
+}
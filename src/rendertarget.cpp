@@ -0,0 +1,99 @@
+#include <rendertarget.h>
+#include <renderthread.h>
+
+#include <algorithm>
+
+using namespace BEG;
+
+void RenderTarget::create() {
+    glGenFramebuffers(1, &mFramebuffer);
+    glGenTextures(1, &mColor);
+    glGenRenderbuffers(1, &mDepth);
+
+    glBindTexture(GL_TEXTURE_2D, mColor);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, mDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, mWidth, mHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mColor, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, mDepth);
+
+    GLenum status{ glCheckFramebufferStatus(GL_FRAMEBUFFER) };
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        throw RenderTarget::RenderTargetError::IncompleteFramebufferError;
+}
+
+void RenderTarget::release() {
+    if (mFramebuffer == 0)
+        return;
+
+    glDeleteFramebuffers(1, &mFramebuffer);
+    glDeleteTextures(1, &mColor);
+    glDeleteRenderbuffers(1, &mDepth);
+
+    mFramebuffer = 0;
+    mColor = 0;
+    mDepth = 0;
+}
+
+RenderTarget::RenderTarget(int width, int height) : mWidth{ std::max(width, 1) }, mHeight{ std::max(height, 1) } {}
+
+RenderTarget::~RenderTarget() {
+    if (mFramebuffer == 0)
+        return;
+
+    RenderThread::release([framebuffer = mFramebuffer, color = mColor, depth = mDepth] {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &color);
+        glDeleteRenderbuffers(1, &depth);
+    });
+}
+
+int RenderTarget::width() const {
+    return mWidth;
+}
+
+int RenderTarget::height() const {
+    return mHeight;
+}
+
+void RenderTarget::resize(int width, int height) {
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+
+    if (mFramebuffer != 0 && width == mWidth && height == mHeight)
+        return;
+
+    release();
+    mWidth = width;
+    mHeight = height;
+    create();
+}
+
+void RenderTarget::bind() {
+    if (mFramebuffer == 0)
+        create();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+}
+
+void RenderTarget::blitToScreen() const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, mWidth, mHeight, 0, 0, mWidth, mHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+unsigned int RenderTarget::colorTexture() const {
+    return mColor;
+}
@@ -0,0 +1,150 @@
+#include <renderthread.h>
+
+#include <algorithm>
+
+using namespace BEG;
+
+std::atomic<RenderThread*> RenderThread::sActive{ nullptr };
+
+RenderThread::~RenderThread() {
+    if (running())
+        stop();
+}
+
+void RenderThread::run() {
+    BEG_PROFILE_THREAD("render");
+    glfwMakeContextCurrent(mWindow);
+
+    for (;;) {
+        RenderCommand command{ mCommands.pop() };
+
+        switch (command.type) {
+            case RenderCommand::Type::DrawFrame: {
+                mSnapshots.acquire();
+
+                const FrameSnapshot& frame{ mSnapshots.front() };
+
+                {
+                    StatsScope stats{ mStats, FrameStats::Draw };
+                    BEG_PROFILE_SCOPE("draw");
+                    mRenderer.draw(frame);
+                }
+                {
+                    StatsScope stats{ mStats, FrameStats::Swap };
+                    BEG_PROFILE_SCOPE("swap");
+                    glfwSwapBuffers(mWindow);
+                }
+
+                collectGarbage(frame.frame);
+
+                mFramesDrawn.store(frame.frame + 1, std::memory_order_release);
+                mFramesDrawn.notify_all();
+                break;
+            }
+            case RenderCommand::Type::Execute: {
+                BEG_PROFILE_SCOPE("execute");
+                (*command.task)();
+                break;
+            }
+            case RenderCommand::Type::Stop:
+                glfwMakeContextCurrent(nullptr);
+                return;
+        }
+    }
+}
+
+void RenderThread::collectGarbage(unsigned long drawnFrame) {
+    std::vector<std::function<void()>> ready{};
+
+    {
+        std::lock_guard<std::mutex> lock{ mGarbageMutex };
+        auto split{ std::stable_partition(mGarbage.begin(), mGarbage.end(), [drawnFrame](const auto& garbage) {
+            return garbage.first > drawnFrame;
+        }) };
+
+        for (auto it{ split }; it != mGarbage.end(); ++it) {
+            ready.push_back(std::move(it->second));
+        }
+        mGarbage.erase(split, mGarbage.end());
+    }
+
+    for (auto& work : ready) {
+        work();
+    }
+}
+
+void RenderThread::start(GLFWwindow* window) {
+    mWindow = window;
+    mFramesSubmitted.store(0);
+    mFramesDrawn.store(0);
+
+    glfwMakeContextCurrent(nullptr);
+
+    mThread = std::thread{ &RenderThread::run, this };
+    sActive.store(this, std::memory_order_release);
+}
+
+void RenderThread::stop() {
+    mCommands.push({ RenderCommand::Type::Stop, nullptr });
+    mThread.join();
+
+    sActive.store(nullptr, std::memory_order_release);
+    glfwMakeContextCurrent(mWindow);
+
+    /* nothing is in flight any more */
+    std::vector<std::pair<unsigned long, std::function<void()>>> garbage{};
+    {
+        std::lock_guard<std::mutex> lock{ mGarbageMutex };
+        garbage.swap(mGarbage);
+    }
+
+    for (auto& [frame, work] : garbage) {
+        work();
+    }
+}
+
+bool RenderThread::running() const {
+    return mThread.joinable();
+}
+
+void RenderThread::submitFrame() {
+    mCommands.push({ RenderCommand::Type::DrawFrame, nullptr });
+    mFramesSubmitted.fetch_add(1, std::memory_order_release);
+}
+
+void RenderThread::waitForFrame(unsigned long frame) {
+    unsigned long drawn{ mFramesDrawn.load(std::memory_order_acquire) };
+    while (drawn < frame) {
+        mFramesDrawn.wait(drawn, std::memory_order_acquire);
+        drawn = mFramesDrawn.load(std::memory_order_acquire);
+    }
+}
+
+void RenderThread::execute(const std::function<void()>& work) {
+    RenderThread* active{ sActive.load(std::memory_order_acquire) };
+
+    if (active == nullptr || glfwGetCurrentContext() != nullptr) {
+        work();
+        return;
+    }
+
+    std::packaged_task<void()> task{ work };
+    std::future<void> result{ task.get_future() };
+
+    active->mCommands.push({ RenderCommand::Type::Execute, &task });
+    result.get();
+}
+
+void RenderThread::release(std::function<void()> work) {
+    if (glfwGetCurrentContext() != nullptr) {
+        work();
+        return;
+    }
+
+    RenderThread* active{ sActive.load(std::memory_order_acquire) };
+    if (active == nullptr)
+        return; /* no context anywhere, the objects died with it */
+
+    std::lock_guard<std::mutex> lock{ active->mGarbageMutex };
+    active->mGarbage.push_back({ active->mFramesSubmitted.load(std::memory_order_acquire), std::move(work) });
+}
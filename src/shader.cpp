@@ -1,4 +1,5 @@
 #include <shader.h>
+#include <renderthread.h>
 
 using namespace BEG;
 
@@ -58,37 +59,47 @@ unsigned int Shader::compileShader(GLenum type, const std::string& src) {
     return id;
 }
 
-Shader::Shader(const std::string& vertSrc, const std::string& fragSrc) : mProgramId{ glCreateProgram() } {
-    unsigned int vertShader{ Shader::compileShader(GL_VERTEX_SHADER, vertSrc) };
-    unsigned int fragShader{ Shader::compileShader(GL_FRAGMENT_SHADER, fragSrc) };
+Shader::Shader(const std::string& vertSrc, const std::string& fragSrc) : mProgramId{ 0 } {
+    /* compiles on whichever thread currently owns the GL context, errors are rethrown here */
+    RenderThread::execute([this, &vertSrc, &fragSrc] {
+        mProgramId = glCreateProgram();
 
-    glAttachShader(mProgramId, vertShader);
-    glAttachShader(mProgramId, fragShader);
+        unsigned int vertShader{ Shader::compileShader(GL_VERTEX_SHADER, vertSrc) };
+        unsigned int fragShader{ Shader::compileShader(GL_FRAGMENT_SHADER, fragSrc) };
 
-    glLinkProgram(mProgramId);
+        glAttachShader(mProgramId, vertShader);
+        glAttachShader(mProgramId, fragShader);
 
-    glDeleteShader(vertShader);
-    glDeleteShader(fragShader);
+        glLinkProgram(mProgramId);
 
-    int success{};
-    glGetProgramiv(mProgramId, GL_LINK_STATUS, &success);
-    if (!success) {
-        int infoLogLength{};
-        glGetProgramiv(mProgramId, GL_INFO_LOG_LENGTH, &infoLogLength);
+        glDeleteShader(vertShader);
+        glDeleteShader(fragShader);
 
-        char *buf = new char[infoLogLength];
-        glGetProgramInfoLog(mProgramId, infoLogLength, NULL, buf);
+        int success{};
+        glGetProgramiv(mProgramId, GL_LINK_STATUS, &success);
+        if (!success) {
+            int infoLogLength{};
+            glGetProgramiv(mProgramId, GL_INFO_LOG_LENGTH, &infoLogLength);
 
-        Shader::ShaderError err { Shader::ShaderErrorType::ProgramLinkingError, buf };
+            char *buf = new char[infoLogLength];
+            glGetProgramInfoLog(mProgramId, infoLogLength, NULL, buf);
 
-        delete[] buf;
+            Shader::ShaderError err { Shader::ShaderErrorType::ProgramLinkingError, buf };
 
-        throw err;
-    }
+            delete[] buf;
+
+            throw err;
+        }
+    });
 }
 
 Shader::~Shader() {
-    glDeleteProgram(mProgramId);
+    if (mProgramId == 0)
+        return;
+
+    RenderThread::release([id = mProgramId] {
+        glDeleteProgram(id);
+    });
 }
 
 Shader& Shader::operator=(Shader &&shader) {
@@ -99,55 +110,79 @@ Shader& Shader::operator=(Shader &&shader) {
 }
 
 template <>
-void Shader::setUniform<int>(const std::string& name, const int& value) {
-    glUniform1i(glGetUniformLocation(mProgramId, name.c_str()), value);
+void Shader::setUniform<int>(unsigned int program, const std::string& name, const int& value) {
+    glUniform1i(glGetUniformLocation(program, name.c_str()), value);
+}
+
+template <>
+void Shader::setUniform<bool>(unsigned int program, const std::string& name, const bool& value) {
+    glUniform1i(glGetUniformLocation(program, name.c_str()), static_cast<int>(value));
+}
+
+template <>
+void Shader::setUniform<float>(unsigned int program, const std::string& name, const float& value) {
+    glUniform1f(glGetUniformLocation(program, name.c_str()), value);
 }
 
 template <>
-void Shader::setUniform<bool>(const std::string& name, const bool& value) {
-    glUniform1i(glGetUniformLocation(mProgramId, name.c_str()), static_cast<int>(value));
+void Shader::setUniform<double>(unsigned int program, const std::string& name, const double& value) {
+    glUniform1d(glGetUniformLocation(program, name.c_str()), value);
 }
 
 template <>
-void Shader::setUniform<float>(const std::string& name, const float& value) {
-    glUniform1f(glGetUniformLocation(mProgramId, name.c_str()), value);
+void Shader::setUniform<Vector<2>>(unsigned int program, const std::string& name, const Vector<2>& value) {
+    glUniform2f(glGetUniformLocation(program, name.c_str()), value.x(), value.y());
 }
 
 template <>
-void Shader::setUniform<double>(const std::string& name, const double& value) {
-    glUniform1d(glGetUniformLocation(mProgramId, name.c_str()), value);
+void Shader::setUniform<Vector<3>>(unsigned int program, const std::string& name, const Vector<3>& value) {
+    glUniform3f(glGetUniformLocation(program, name.c_str()), value.x(), value.y(), value.z());
 }
 
 template <>
-void Shader::setUniform<Vector<2>>(const std::string& name, const Vector<2>& value) {
-    glUniform2f(glGetUniformLocation(mProgramId, name.c_str()), value.x(), value.y());
+void Shader::setUniform<Vector<4>>(unsigned int program, const std::string& name, const Vector<4>& value) {
+    glUniform4f(glGetUniformLocation(program, name.c_str()), value.x(), value.y(), value.z(), value.w());
 }
 
 template <>
-void Shader::setUniform<Vector<3>>(const std::string& name, const Vector<3>& value) {
-    glUniform3f(glGetUniformLocation(mProgramId, name.c_str()), value.x(), value.y(), value.z());
+void Shader::setUniform<Matrix<2>>(unsigned int program, const std::string& name, const Matrix<2>& value) {
+    glUniformMatrix2fv(glGetUniformLocation(program, name.c_str()), 1, GL_TRUE, value.data().data());
 }
 
 template <>
-void Shader::setUniform<Vector<4>>(const std::string& name, const Vector<4>& value) {
-    glUniform4f(glGetUniformLocation(mProgramId, name.c_str()), value.x(), value.y(), value.z(), value.w());
+void Shader::setUniform<Matrix<3>>(unsigned int program, const std::string& name, const Matrix<3>& value) {
+    glUniformMatrix3fv(glGetUniformLocation(program, name.c_str()), 1, GL_TRUE, value.data().data());
 }
 
 template <>
-void Shader::setUniform<Matrix<2>>(const std::string& name, const Matrix<2>& value) {
-    glUniformMatrix2fv(glGetUniformLocation(mProgramId, name.c_str()), 1, GL_TRUE, value.data().data());
+void Shader::setUniform<Matrix<4>>(unsigned int program, const std::string& name, const Matrix<4>& value) {
+    glUniformMatrix4fv(glGetUniformLocation(program, name.c_str()), 1, GL_TRUE, value.data().data());
 }
 
+/* GPU layout types are already column-major, so unlike Matrix they go up untransposed */
 template <>
-void Shader::setUniform<Matrix<3>>(const std::string& name, const Matrix<3>& value) {
-    glUniformMatrix3fv(glGetUniformLocation(mProgramId, name.c_str()), 1, GL_TRUE, value.data().data());
+void Shader::setUniform<GPU::Vec3>(unsigned int program, const std::string& name, const GPU::Vec3& value) {
+    glUniform3fv(glGetUniformLocation(program, name.c_str()), 1, &value.x);
 }
 
 template <>
-void Shader::setUniform<Matrix<4>>(const std::string& name, const Matrix<4>& value) {
-    glUniformMatrix4fv(glGetUniformLocation(mProgramId, name.c_str()), 1, GL_TRUE, value.data().data());
+void Shader::setUniform<GPU::Vec4>(unsigned int program, const std::string& name, const GPU::Vec4& value) {
+    glUniform4fv(glGetUniformLocation(program, name.c_str()), 1, &value.x);
+}
+
+template <>
+void Shader::setUniform<GPU::Mat4>(unsigned int program, const std::string& name, const GPU::Mat4& value) {
+    glUniformMatrix4fv(glGetUniformLocation(program, name.c_str()), 1, GL_FALSE, value.data());
+}
+
+void Shader::use(unsigned int program) {
+    glUseProgram(program);
+}
+
+unsigned int Shader::id() const {
+    return mProgramId;
 }
 
 void Shader::use() {
-    glUseProgram(mProgramId);
+    use(mProgramId);
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include <snapshot.h>
+
+using namespace BEG;
+
+void FrameSnapshot::clear() {
+    for (ViewState& view : views) {
+        view.draws.clear();
+        view.batches.clear();
+    }
+
+    draws.clear();
+
+    directionalLights.clear();
+    pointLights.clear();
+    spotLights.clear();
+}
@@ -0,0 +1,306 @@
+#include <stats.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+using namespace BEG;
+
+FrameStats::Series* FrameStats::find(std::string_view series) {
+    for (Series& s : mSeries) {
+        if (s.name == series)
+            return &s;
+    }
+
+    return nullptr;
+}
+
+const FrameStats::Series* FrameStats::find(std::string_view series) const {
+    for (const Series& s : mSeries) {
+        if (s.name == series)
+            return &s;
+    }
+
+    return nullptr;
+}
+
+FrameStats::Series& FrameStats::findOrAdd(std::string_view series) {
+    Series* s{ find(series) };
+    if (s != nullptr)
+        return *s;
+
+    mSeries.emplace_back();
+    mSeries.back().name = series;
+
+    return mSeries.back();
+}
+
+std::vector<double> FrameStats::window(const Series& series) const {
+    size_t size{ std::min(series.count, Window) };
+    return { series.samples.begin(), series.samples.begin() + static_cast<std::ptrdiff_t>(size) };
+}
+
+double FrameStats::secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void FrameStats::record(std::string_view series, double seconds) {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    Series& s{ findOrAdd(series) };
+
+    s.samples[s.count % Window] = seconds;
+    ++s.count;
+
+    s.total += seconds;
+    s.max = std::max(s.max, seconds);
+    if (seconds > mHitchThreshold)
+        ++s.hitches;
+}
+
+void FrameStats::recordCounters(std::string_view series, const PerfCounters::Values& counters) {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    Series& s{ findOrAdd(series) };
+
+    for (size_t i{ 0 }; i < PerfCounters::CounterCount; ++i) {
+        s.counters[i] += counters[i];
+    }
+    ++s.counted;
+}
+
+FrameStats::Summary FrameStats::summary(std::string_view series) const {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    const Series* s{ find(series) };
+    if (s == nullptr)
+        return {};
+
+    std::vector<double> samples{ window(*s) };
+    if (samples.empty())
+        return {};
+
+    std::sort(samples.begin(), samples.end());
+
+    /* nearest-rank percentile */
+    auto percentile{ [&samples](double p) {
+        size_t rank{ static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size()))) };
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    } };
+
+    Summary result{};
+    result.samples = samples.size();
+
+    double sum{ 0.0 };
+    for (double sample : samples) {
+        sum += sample;
+        if (sample > mHitchThreshold)
+            ++result.hitches;
+    }
+
+    result.mean = sum / static_cast<double>(samples.size());
+    result.p50 = percentile(0.50);
+    result.p95 = percentile(0.95);
+    result.p99 = percentile(0.99);
+    result.max = samples.back();
+
+    return result;
+}
+
+std::array<size_t, FrameStats::HistogramBuckets> FrameStats::histogram(std::string_view series) const {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    std::array<size_t, HistogramBuckets> buckets{};
+
+    const Series* s{ find(series) };
+    if (s == nullptr)
+        return buckets;
+
+    for (double sample : window(*s)) {
+        size_t bucket{ static_cast<size_t>(std::max(sample, 0.0) / HistogramBucketWidth) };
+        ++buckets[std::min(bucket, HistogramBuckets - 1)];
+    }
+
+    return buckets;
+}
+
+std::vector<std::string> FrameStats::series() const {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    std::vector<std::string> names{};
+    for (const Series& s : mSeries) {
+        names.push_back(s.name);
+    }
+
+    return names;
+}
+
+size_t FrameStats::totalSamples(std::string_view series) const {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    const Series* s{ find(series) };
+    return s == nullptr ? 0 : s->count;
+}
+
+size_t FrameStats::totalHitches(std::string_view series) const {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    const Series* s{ find(series) };
+    return s == nullptr ? 0 : s->hitches;
+}
+
+std::array<double, PerfCounters::CounterCount> FrameStats::counters(std::string_view series) const {
+    std::lock_guard<std::mutex> lock{ mMutex };
+
+    std::array<double, PerfCounters::CounterCount> means{};
+
+    const Series* s{ find(series) };
+    if (s == nullptr || s->counted == 0)
+        return means;
+
+    for (size_t i{ 0 }; i < PerfCounters::CounterCount; ++i) {
+        means[i] = static_cast<double>(s->counters[i]) / static_cast<double>(s->counted);
+    }
+
+    return means;
+}
+
+double FrameStats::hitchThreshold() const {
+    std::lock_guard<std::mutex> lock{ mMutex };
+    return mHitchThreshold;
+}
+
+void FrameStats::hitchThreshold(double seconds) {
+    std::lock_guard<std::mutex> lock{ mMutex };
+    mHitchThreshold = seconds;
+}
+
+bool FrameStats::write(const std::string& path) const {
+    std::ofstream out{ path };
+    if (!out)
+        return false;
+
+    bool csv{ path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0 };
+
+    if (csv) {
+        out << "series,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,hitches,total_samples,total_hitches,session_max_ms";
+        for (size_t i{ 0 }; i < PerfCounters::CounterCount; ++i) {
+            out << ',' << PerfCounters::name(static_cast<PerfCounters::Counter>(i));
+        }
+        out << ",ipc\n";
+    } else {
+        out << "{\"hitchThresholdMs\":" << hitchThreshold() * 1000.0 << ",\"series\":[";
+    }
+
+    bool first{ true };
+    for (const std::string& name : series()) {
+        Summary s{ summary(name) };
+
+        double sessionMax{};
+        size_t counted{};
+        {
+            std::lock_guard<std::mutex> lock{ mMutex };
+            sessionMax = find(name)->max;
+            counted = find(name)->counted;
+        }
+
+        std::array<double, PerfCounters::CounterCount> counts{ counters(name) };
+        double cycles{ counts[static_cast<size_t>(PerfCounters::Counter::Cycles)] };
+        double ipc{ cycles > 0.0 ? counts[static_cast<size_t>(PerfCounters::Counter::Instructions)] / cycles : 0.0 };
+
+        if (csv) {
+            out << name << ',' << s.samples << ',' << s.mean * 1000.0 << ',' << s.p50 * 1000.0 << ','
+                << s.p95 * 1000.0 << ',' << s.p99 * 1000.0 << ',' << s.max * 1000.0 << ',' << s.hitches << ','
+                << totalSamples(name) << ',' << totalHitches(name) << ',' << sessionMax * 1000.0;
+            for (double count : counts) {
+                out << ',' << count;
+            }
+            out << ',' << ipc << '\n';
+        } else {
+            if (!first)
+                out << ',';
+            first = false;
+
+            out << "{\"name\":\"" << name << "\",\"samples\":" << s.samples << ",\"meanMs\":" << s.mean * 1000.0
+                << ",\"p50Ms\":" << s.p50 * 1000.0 << ",\"p95Ms\":" << s.p95 * 1000.0 << ",\"p99Ms\":" << s.p99 * 1000.0
+                << ",\"maxMs\":" << s.max * 1000.0 << ",\"hitches\":" << s.hitches << ",\"totalSamples\":" << totalSamples(name)
+                << ",\"totalHitches\":" << totalHitches(name) << ",\"sessionMaxMs\":" << sessionMax * 1000.0;
+
+            /* mean counter values per sample */
+            if (counted > 0) {
+                out << ",\"counters\":{";
+                for (size_t i{ 0 }; i < PerfCounters::CounterCount; ++i) {
+                    out << '"' << PerfCounters::name(static_cast<PerfCounters::Counter>(i)) << "\":" << counts[i] << ',';
+                }
+                out << "\"ipc\":" << ipc << '}';
+            }
+
+            out << '}';
+        }
+    }
+
+    if (!csv)
+        out << "]}\n";
+
+    return static_cast<bool>(out);
+}
+
+namespace {
+
+thread_local StatsScope* tCurrentScope{ nullptr };
+
+}
+
+StatsScope::StatsScope(FrameStats& stats, std::string_view series)
+    : mStats{ stats }, mSeries{ series }, mStart{}, mCounting{ PerfCounters::enabled() }, mCounters{},
+      mParent{ tCurrentScope }, mHasChildren{ false }, mChildCounters{}, mOwnReads{}, mChildReads{} {
+    tCurrentScope = this;
+
+    /* counters are read outside of the timed region so the syscall doesn't inflate the timings */
+    if (mCounting) {
+        if (mParent != nullptr)
+            mParent->mHasChildren = true;
+
+        FrameStats::Clock::time_point before{ FrameStats::Clock::now() };
+        mCounters = PerfCounters::read();
+        mStart = FrameStats::Clock::now();
+        mOwnReads = mStart - before;
+        return;
+    }
+
+    mStart = FrameStats::Clock::now();
+}
+
+StatsScope::~StatsScope() {
+    FrameStats::Clock::time_point end{ FrameStats::Clock::now() };
+    double elapsed{ std::chrono::duration<double>(end - mStart - mChildReads).count() };
+
+    tCurrentScope = mParent;
+
+    if (mCounting) {
+        /* a scope with nested ones reports what they counted, its own reads would include theirs */
+        PerfCounters::Values delta{ mChildCounters };
+        if (!mHasChildren) {
+            delta = PerfCounters::read();
+            for (size_t i{ 0 }; i < PerfCounters::CounterCount; ++i) {
+                delta[i] -= mCounters[i];
+            }
+
+            mOwnReads += FrameStats::Clock::now() - end;
+        }
+
+        mStats.recordCounters(mSeries, delta);
+
+        if (mParent != nullptr) {
+            for (size_t i{ 0 }; i < PerfCounters::CounterCount; ++i) {
+                mParent->mChildCounters[i] += delta[i];
+            }
+        }
+    }
+
+    /* every read at or below this scope happened inside the parent's timed region */
+    if (mParent != nullptr)
+        mParent->mChildReads += mOwnReads + mChildReads;
+
+    mStats.record(mSeries, elapsed);
+}
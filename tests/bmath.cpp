@@ -0,0 +1,1060 @@
+/*
+ * bmath correctness: every operation is checked against a double precision
+ * reference, allowing a few ULP, on seeded random inputs. Runs headless from
+ * `meson test`.
+ */
+
+#include <bmath.h>
+#include <affine.h>
+#include <batch.h>
+#include <camera.h>
+#include <fastmath.h>
+#include <geometry.h>
+#include <gpu.h>
+#include <meshopt.h>
+#include <renderqueue.h>
+#include <stats.h>
+#include <trs.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace BEG;
+
+namespace {
+
+int sFailures{ 0 };
+int sChecks{ 0 };
+
+std::mt19937 sRandom{ 20240601 };
+
+float uniform(float min, float max) {
+    return std::uniform_real_distribution<float>{ min, max }(sRandom);
+}
+
+/*
+ * error in units of the float spacing at max(|ref|, scale). Sums that can
+ * cancel pass the sum of their absolute terms as `scale`, since the result
+ * itself says nothing about how much rounding went into it.
+ */
+double ulps(float value, double ref, double scale) {
+    double error{ std::fabs(static_cast<double>(value) - ref) };
+    if (error == 0.0)
+        return 0.0;
+
+    float magnitude{ static_cast<float>(std::max(std::fabs(ref), scale)) };
+    double spacing{ static_cast<double>(std::nextafter(magnitude, INFINITY)) - static_cast<double>(magnitude) };
+    return error / spacing;
+}
+
+void check(bool ok, const char* what, double detail = 0.0) {
+    ++sChecks;
+    if (!ok) {
+        ++sFailures;
+        std::printf("FAIL %s (%g)\n", what, detail);
+    }
+}
+
+/* tracks the worst error of a whole test, so a failure prints once; absolute tests compare plain differences */
+struct Worst {
+    const char* name;
+    double limit;
+    bool absolute{ false };
+    double worst{ 0.0 };
+
+    void add(float value, double ref, double scale = 0.0) {
+        double error{ absolute ? std::fabs(static_cast<double>(value) - ref) : ulps(value, ref, scale) };
+        if (std::isnan(error))
+            error = INFINITY;
+        worst = std::max(worst, error);
+    }
+
+    ~Worst() {
+        check(worst <= limit, name, worst);
+        std::printf("  %-28s worst %9.3g %s (limit %g)\n", name, worst, absolute ? "abs" : "ulp", limit);
+    }
+};
+
+double maxAbs(const std::array<double, 16>& m) {
+    double result{ 0.0 };
+    for (double value : m) {
+        result = std::max(result, std::fabs(value));
+    }
+    return result;
+}
+
+using Mat = std::array<double, 16>;
+using Quat = std::array<double, 4>;
+
+Mat reference(const Matrix<4>& m) {
+    Mat result{};
+    for (size_t i{ 0 }; i < 16; ++i) {
+        result[i] = m[i];
+    }
+    return result;
+}
+
+Mat multiply(const Mat& a, const Mat& b) {
+    Mat result{};
+    for (size_t r{ 0 }; r < 4; ++r) {
+        for (size_t c{ 0 }; c < 4; ++c) {
+            for (size_t k{ 0 }; k < 4; ++k) {
+                result[(r * 4) + c] += a[(r * 4) + k] * b[(k * 4) + c];
+            }
+        }
+    }
+    return result;
+}
+
+/* Gauss-Jordan with partial pivoting */
+Mat invert(Mat a) {
+    Mat result{};
+    for (size_t i{ 0 }; i < 4; ++i) {
+        result[i * 5] = 1.0;
+    }
+
+    for (size_t c{ 0 }; c < 4; ++c) {
+        size_t pivot{ c };
+        for (size_t r{ c + 1 }; r < 4; ++r) {
+            if (std::fabs(a[(r * 4) + c]) > std::fabs(a[(pivot * 4) + c]))
+                pivot = r;
+        }
+        for (size_t k{ 0 }; k < 4; ++k) {
+            std::swap(a[(c * 4) + k], a[(pivot * 4) + k]);
+            std::swap(result[(c * 4) + k], result[(pivot * 4) + k]);
+        }
+
+        double scale{ 1.0 / a[c * 5] };
+        for (size_t k{ 0 }; k < 4; ++k) {
+            a[(c * 4) + k] *= scale;
+            result[(c * 4) + k] *= scale;
+        }
+
+        for (size_t r{ 0 }; r < 4; ++r) {
+            if (r == c)
+                continue;
+            double factor{ a[(r * 4) + c] };
+            for (size_t k{ 0 }; k < 4; ++k) {
+                a[(r * 4) + k] -= factor * a[(c * 4) + k];
+                result[(r * 4) + k] -= factor * result[(c * 4) + k];
+            }
+        }
+    }
+
+    return result;
+}
+
+double determinant(const Mat& a) {
+    /* Laplace along the first row over 3x3 minors */
+    auto minor3{ [&a](size_t skip) {
+        std::array<double, 9> m{};
+        size_t n{ 0 };
+        for (size_t r{ 1 }; r < 4; ++r) {
+            for (size_t c{ 0 }; c < 4; ++c) {
+                if (c != skip)
+                    m[n++] = a[(r * 4) + c];
+            }
+        }
+        return (m[0] * ((m[4] * m[8]) - (m[5] * m[7]))) - (m[1] * ((m[3] * m[8]) - (m[5] * m[6]))) + (m[2] * ((m[3] * m[7]) - (m[4] * m[6])));
+    } };
+
+    return (a[0] * minor3(0)) - (a[1] * minor3(1)) + (a[2] * minor3(2)) - (a[3] * minor3(3));
+}
+
+Quat reference(const Quaternion& q) {
+    return { q.w(), q.x(), q.y(), q.z() };
+}
+
+Quat multiply(const Quat& a, const Quat& b) {
+    return {
+        (a[0] * b[0]) - (a[1] * b[1]) - (a[2] * b[2]) - (a[3] * b[3]),
+        (a[0] * b[1]) + (a[1] * b[0]) + (a[2] * b[3]) - (a[3] * b[2]),
+        (a[0] * b[2]) - (a[1] * b[3]) + (a[2] * b[0]) + (a[3] * b[1]),
+        (a[0] * b[3]) + (a[1] * b[2]) - (a[2] * b[1]) + (a[3] * b[0])
+    };
+}
+
+std::array<double, 3> rotate(const Quat& q, const std::array<double, 3>& v) {
+    Quat p{ multiply(multiply(q, { 0.0, v[0], v[1], v[2] }), { q[0], -q[1], -q[2], -q[3] }) };
+    return { p[1], p[2], p[3] };
+}
+
+Matrix<4> randomMatrix() {
+    Matrix<4> m{};
+    for (size_t i{ 0 }; i < 16; ++i) {
+        m[i] = uniform(-2.0f, 2.0f);
+    }
+    /* keep it comfortably invertible */
+    for (size_t i{ 0 }; i < 4; ++i) {
+        m[i * 5] += 5.0f;
+    }
+    return m;
+}
+
+Vector<3> randomVector(float range = 10.0f) {
+    return { uniform(-range, range), uniform(-range, range), uniform(-range, range) };
+}
+
+Quaternion randomRotation() {
+    return Quaternion{ uniform(-Pi, Pi), uniform(-Pi, Pi), uniform(-Pi, Pi) }.normalized();
+}
+
+constexpr int Iterations{ 20000 };
+
+void testVectors() {
+    std::printf("vectors\n");
+    Worst dot3{ "Vector<3>::dot", 2.0 }, dot4{ "Vector<4>::dot", 2.0 }, cross{ "Vector<3>::cross", 2.0 };
+    Worst magnitude{ "Vector<3>::magnitude", 2.0 }, normalized{ "Vector<3>::normalized", 2.0 };
+    Worst addScaled{ "Vector<4>::addScaled", 2.0 };
+
+    for (int i{ 0 }; i < Iterations; ++i) {
+        Vector<3> a{ randomVector() }, b{ randomVector() };
+        double ax{ a.x() }, ay{ a.y() }, az{ a.z() }, bx{ b.x() }, by{ b.y() }, bz{ b.z() };
+
+        dot3.add(a.dot(b), (ax * bx) + (ay * by) + (az * bz), std::fabs(ax * bx) + std::fabs(ay * by) + std::fabs(az * bz));
+
+        Vector<3> c{ a.cross(b) };
+        cross.add(c.x(), (ay * bz) - (az * by), std::fabs(ay * bz) + std::fabs(az * by));
+        cross.add(c.y(), (az * bx) - (ax * bz), std::fabs(az * bx) + std::fabs(ax * bz));
+        cross.add(c.z(), (ax * by) - (ay * bx), std::fabs(ax * by) + std::fabs(ay * bx));
+
+        double length{ std::sqrt((ax * ax) + (ay * ay) + (az * az)) };
+        magnitude.add(a.magnitude(), length);
+
+        Vector<3> n{ a.normalized() };
+        normalized.add(n.x(), ax / length, 1.0);
+        normalized.add(n.y(), ay / length, 1.0);
+        normalized.add(n.z(), az / length, 1.0);
+
+        Vector<4> p{ a, uniform(-10.0f, 10.0f) }, q{ b, uniform(-10.0f, 10.0f) };
+        double pw{ p.w() }, qw{ q.w() };
+        dot4.add(Vector<4>::dot(p, q), (ax * bx) + (ay * by) + (az * bz) + (pw * qw), std::fabs(ax * bx) + std::fabs(ay * by) + std::fabs(az * bz) + std::fabs(pw * qw));
+
+        float s{ uniform(-2.0f, 2.0f) };
+        Vector<4> r{ p };
+        r.addScaled(q, s);
+        for (size_t k{ 0 }; k < 4; ++k) {
+            double product{ static_cast<double>(q[k]) * s };
+            addScaled.add(r[k], static_cast<double>(p[k]) + product, std::fabs(p[k]) + std::fabs(product));
+        }
+    }
+}
+
+void testMatrices() {
+    std::printf("matrices\n");
+    Worst product{ "Matrix<4> * Matrix<4>", 4.0 }, transform{ "Matrix<4> * Vector<4>", 4.0 };
+    Worst inverse{ "Matrix<4>::inverse", 64.0 }, adjoint{ "Matrix<4>::adjointInverse", 64.0 };
+    Worst det{ "Matrix<4>::determinant", 16.0 };
+    Worst affine{ "Matrix<4>::inverseAffine", 16.0 }, rigid{ "Matrix<4>::inverseRigid", 16.0 };
+    Worst lu{ "Matrix<5>::inverse (LU)", 0.0 };
+
+    for (int i{ 0 }; i < Iterations; ++i) {
+        Matrix<4> a{ randomMatrix() }, b{ randomMatrix() };
+        Mat ra{ reference(a) }, rb{ reference(b) };
+
+        Mat ab{ multiply(ra, rb) };
+        Matrix<4> fab{ a * b };
+        for (size_t k{ 0 }; k < 16; ++k) {
+            double scale{ 0.0 };
+            for (size_t j{ 0 }; j < 4; ++j) {
+                scale += std::fabs(ra[((k / 4) * 4) + j] * rb[(j * 4) + (k % 4)]);
+            }
+            product.add(fab[k], ab[k], scale);
+        }
+
+        Vector<4> v{ randomVector(), 1.0f };
+        Vector<4> fv{ a * v };
+        for (size_t r{ 0 }; r < 4; ++r) {
+            double sum{ 0.0 }, scale{ 0.0 };
+            for (size_t k{ 0 }; k < 4; ++k) {
+                sum += ra[(r * 4) + k] * v[k];
+                scale += std::fabs(ra[(r * 4) + k] * v[k]);
+            }
+            transform.add(fv[r], sum, scale);
+        }
+
+        Mat inv{ invert(ra) };
+        Matrix<4> fi{ a.inverse() }, fa{ a.adjointInverse() };
+        for (size_t k{ 0 }; k < 16; ++k) {
+            inverse.add(fi[k], inv[k], maxAbs(inv));
+            adjoint.add(fa[k], inv[k], maxAbs(inv));
+        }
+
+        det.add(a.determinant(), determinant(ra));
+
+        Matrix<4> t{ Affine::trs(randomVector(), randomRotation(), { uniform(0.5f, 2.0f), uniform(0.5f, 2.0f), uniform(0.5f, 2.0f) }) };
+        Mat ti{ invert(reference(t)) };
+        Matrix<4> ta{ t.inverseAffine() };
+        for (size_t k{ 0 }; k < 16; ++k) {
+            affine.add(ta[k], ti[k], maxAbs(ti));
+        }
+
+        Matrix<4> r{ Affine::tr(randomVector(), randomRotation()) };
+        Mat ri{ invert(reference(r)) };
+        Matrix<4> rr{ r.inverseRigid() };
+        for (size_t k{ 0 }; k < 16; ++k) {
+            rigid.add(rr[k], ri[k], maxAbs(ri));
+        }
+    }
+
+    /* LU on a matrix whose inverse is exact in float */
+    Matrix<5> diagonal{};
+    for (size_t i{ 0 }; i < 5; ++i) {
+        diagonal.at(i, i) = static_cast<float>(1 << i);
+    }
+    Matrix<5> diagonalInverse{ diagonal.inverse() };
+    for (size_t i{ 0 }; i < 5; ++i) {
+        lu.add(diagonalInverse.at(i, i), 1.0 / static_cast<double>(1 << i));
+    }
+
+    Matrix<3> m3{ 2.0f, 0.0f, 1.0f, 1.0f, 3.0f, 0.0f, 0.0f, 1.0f, 4.0f };
+    check((m3 * m3.inverse()).at(1, 1) > 0.9999f, "Matrix<3>::inverse");
+    check(m3.determinant() == m3.adjointDeterminant(), "Matrix<3>::determinant");
+}
+
+void testQuaternions() {
+    std::printf("quaternions\n");
+    Worst product{ "Quaternion * Quaternion", 4.0 }, rotation{ "Quaternion::rotate", 8.0 };
+    Worst matrix{ "Quaternion::toMatrix", 8.0 }, slerp{ "Quaternion::slerp", 8.0 };
+
+    for (int i{ 0 }; i < Iterations; ++i) {
+        Quaternion a{ randomRotation() }, b{ randomRotation() };
+        Quat ra{ reference(a) }, rb{ reference(b) };
+
+        Quat ab{ multiply(ra, rb) };
+        Quaternion fab{ a * b };
+        product.add(fab.w(), ab[0], 1.0);
+        product.add(fab.x(), ab[1], 1.0);
+        product.add(fab.y(), ab[2], 1.0);
+        product.add(fab.z(), ab[3], 1.0);
+
+        Vector<3> v{ randomVector() };
+        std::array<double, 3> rv{ rotate(ra, { v.x(), v.y(), v.z() }) };
+        Vector<3> fv{ a.rotate(v) };
+        Vector<3> mv{ a.toMatrix() * Vector<4>(v, 1.0f) };
+        for (size_t k{ 0 }; k < 3; ++k) {
+            rotation.add(fv[k], rv[k], v.magnitude());
+            matrix.add(mv[k], rv[k], v.magnitude());
+        }
+
+        /* slerp against the textbook formula in double, on the shorter arc */
+        double cosine{ (ra[0] * rb[0]) + (ra[1] * rb[1]) + (ra[2] * rb[2]) + (ra[3] * rb[3]) };
+        double sign{ cosine < 0.0 ? -1.0 : 1.0 };
+        double theta{ std::acos(std::min(1.0, std::fabs(cosine))) };
+        double t{ uniform(0.0f, 1.0f) };
+        Quaternion fs{ a.slerp(b, static_cast<float>(t)) };
+        Quat rs{ reference(fs) };
+        if (theta > 0.05) {
+            for (size_t k{ 0 }; k < 4; ++k) {
+                double expected{ ((std::sin((1.0 - t) * theta) * ra[k]) + (std::sin(t * theta) * sign * rb[k])) / std::sin(theta) };
+                slerp.add(static_cast<float>(rs[k]), expected, 1.0);
+            }
+        }
+    }
+
+    Quaternion a{ randomRotation() };
+    Quaternion n{ a.nlerp(a * -1.0f, 0.5f) };
+    check(std::fabs(std::fabs(n.dot(a)) - 1.0f) < 1e-5f, "Quaternion::nlerp takes the shorter arc");
+
+    Quaternion p{ randomRotation() }, q{ randomRotation() }, r{ randomRotation() }, s{ randomRotation() };
+    Quaternion c1{ Quaternion::squadControl(p, q, r) }, c2{ Quaternion::squadControl(q, r, s) };
+    check(std::fabs(Quaternion::squad(q, r, c1, c2, 0.0f).dot(q)) > 0.99999f, "Quaternion::squad starts at a");
+    check(std::fabs(Quaternion::squad(q, r, c1, c2, 1.0f).dot(r)) > 0.99999f, "Quaternion::squad ends at b");
+
+    /* rotations about z, where squad must ease monotonically even when the inner pairs disagree about the shorter arc */
+    auto aboutZ{ [](float angle) { return Quaternion{ std::cos(angle * 0.5f), 0.0f, 0.0f, std::sin(angle * 0.5f) }; } };
+    auto angleOf{ [](const Quaternion& rotation) { return 2.0f * std::atan2(rotation.z(), rotation.w()); } };
+    Quaternion start{ aboutZ(0.0f) }, end{ aboutZ(3.3f) };
+    bool monotonic{ true };
+    float previous{ 0.0f };
+    for (int i{ 1 }; i <= 100; ++i) {
+        float angle{ angleOf(Quaternion::squad(start, end, aboutZ(0.2f), aboutZ(3.0f), static_cast<float>(i) / 100.0f)) };
+        monotonic = monotonic && angle <= previous + 1e-5f;
+        previous = angle;
+    }
+    check(monotonic && std::fabs(previous - (3.3f - (2.0f * Pi))) < 1e-4f, "Quaternion::squad is monotonic across hemispheres", static_cast<double>(previous));
+
+    Quaternion middle{ Quaternion::squad(start, aboutZ(1.0f), aboutZ(0.0f), aboutZ(1.0f), 0.5f) };
+    check(std::fabs(angleOf(middle) - 0.5f) < 1e-5f, "Quaternion::squad midpoint", static_cast<double>(angleOf(middle)));
+
+    /* the tangent at the shared key matches on both sides */
+    Quaternion u{ randomRotation() };
+    Quaternion c3{ Quaternion::squadControl(r, s, u) };
+    const float h{ 1e-3f };
+    Quaternion key{ Quaternion::squad(q, r, c1, c2, 1.0f) }, before{ Quaternion::squad(q, r, c1, c2, 1.0f - h) };
+    Quaternion after{ Quaternion::squad(r, s, c2, c3, h) };
+    after = after.dot(key) < 0.0f ? after * -1.0f : after;
+    before = before.dot(key) < 0.0f ? before * -1.0f : before;
+    Quaternion left{ (key - before) / h }, right{ (after - key) / h };
+    check((left - right).magnitude() < 0.02f * std::max(1.0f, left.magnitude()), "Quaternion::squad is C1 across segments",
+          static_cast<double>((left - right).magnitude()));
+}
+
+void testTransforms() {
+    std::printf("transforms\n");
+    Worst trs{ "Affine::trs", 0.0 }, compose{ "TRS compose", 16.0 }, inverse{ "TRS::inverse", 16.0 };
+
+    for (int i{ 0 }; i < Iterations; ++i) {
+        Vector<3> t{ randomVector() }, s{ uniform(0.5f, 2.0f), uniform(0.5f, 2.0f), uniform(0.5f, 2.0f) };
+        Quaternion r{ randomRotation() };
+
+        /* fused form must match the product chain bit for bit */
+        Matrix<4> fused{ Affine::trs(t, r, s) }, chain{ Affine::translation(t) * r.toMatrix() * Affine::scale(s) };
+        for (size_t k{ 0 }; k < 16; ++k) {
+            trs.add(fused[k], chain[k]);
+        }
+
+        float uniformScale{ uniform(0.5f, 2.0f) };
+        TRS parent{ randomVector(), randomRotation(), { uniformScale, uniformScale, uniformScale } };
+        TRS child{ randomVector(), randomRotation(), s };
+
+        Mat product{ multiply(reference(parent.toMatrix()), reference(child.toMatrix())) };
+        Matrix<4> composed{ (parent * child).toMatrix() };
+        Mat invertedParent{ invert(reference(parent.toMatrix())) };
+        Matrix<4> parentInverse{ parent.inverse().toMatrix() };
+        for (size_t k{ 0 }; k < 16; ++k) {
+            compose.add(composed[k], product[k], maxAbs(product));
+            inverse.add(parentInverse[k], invertedParent[k], maxAbs(invertedParent));
+        }
+    }
+
+    /* round trips: a uniform scale through TRS::inverse, a non-uniform one through the matrix, which TRS must refuse */
+    TRS uniformScaled{ { 1.0f, 2.0f, 3.0f }, Quaternion{ 0.0f, 0.0f, 1.0f }, { 2.0f, 2.0f, 2.0f } };
+    Vector<3> back{ uniformScaled.inverse().transformPoint(uniformScaled.transformPoint({ 1.0f, 0.0f, 0.0f })) };
+    check((back - Vector<3>{ 1.0f, 0.0f, 0.0f }).magnitude() < 1e-5f, "TRS::inverse round trip", static_cast<double>(back.x()));
+
+    TRS nonUniform{ { 1.0f, 2.0f, 3.0f }, Quaternion{ 0.0f, 0.0f, 1.0f }, { 2.0f, 1.0f, 1.0f } };
+    Vector<4> there{ nonUniform.toMatrix() * Vector<4>{ 1.0f, 0.0f, 0.0f, 1.0f } };
+    Vector<4> again{ nonUniform.toMatrix().inverse() * there };
+    check(std::fabs(again.x() - 1.0f) < 1e-5f && std::fabs(again.y()) < 1e-5f && std::fabs(again.z()) < 1e-5f,
+          "non-uniform TRS round trip through the matrix", static_cast<double>(again.x()));
+
+    bool threw{ false };
+    try {
+        static_cast<void>(nonUniform.inverse());
+    } catch (TRSError) {
+        threw = true;
+    }
+    check(threw, "TRS::inverse rejects non-uniform scale");
+}
+
+void testDoublePrecision() {
+    std::printf("double precision\n");
+
+    /* the same templates at double, checked against float results widened; agreement to float precision shows the code paths match */
+    double matrixError{ 0.0 }, rotateError{ 0.0 };
+    for (int i{ 0 }; i < 1000; ++i) {
+        Quaternion r{ randomRotation() };
+        BasicQuaternion<double> wide{ r.w(), r.x(), r.y(), r.z() };
+        Vector<3> v{ randomVector() };
+
+        Vector<3, double> rotated{ wide.rotate(v) }, narrow{ r.rotate(v) };
+        rotateError = std::max(rotateError, (rotated - narrow).magnitude() / 10.0);
+
+        Matrix<4, 4, double> m{ wide.toMatrix() * 2.0 };
+        m.at(0, 3) = 20000.0;
+        Matrix<4, 4, double> identity{ m * m.inverse() };
+        for (size_t k{ 0 }; k < 16; ++k) {
+            matrixError = std::max(matrixError, std::fabs(identity[k] - (k % 5 == 0 ? 1.0 : 0.0)));
+        }
+    }
+    check(rotateError < 1e-6, "BasicQuaternion<double>::rotate", rotateError);
+    check(matrixError < 1e-10, "Matrix<4, 4, double>::inverse", matrixError);
+
+    /* a point half a mm from a camera 20 km out: float positions cannot tell them apart, double ones keep the offset after narrowing */
+    Vector<3, double> camera{ 20000.0, 0.0, -20000.0 }, point{ 20000.0005, 0.0, -20000.0 };
+    Vector<3> relative{ point - camera };
+    check(std::fabs(relative.x() - 0.0005f) < 1e-7f, "camera-relative narrowing keeps small offsets", relative.x());
+    check(Vector<3>(point).x() == Vector<3>(camera).x(), "float positions lose them");
+}
+
+void testBatch() {
+    std::printf("batch kernels\n");
+
+    for (size_t count : { 0u, 1u, 5u, 31u, 1000u, 40000u }) {
+        Matrix<4> m{ Affine::trs(randomVector(), randomRotation(), { 2.0f, 0.5f, 3.0f }) };
+
+        std::vector<Vector<3>> in(count), points(count), directions(count), normals(count);
+        std::vector<float> x(count), y(count), z(count), ox(count), oy(count), oz(count);
+        for (size_t i{ 0 }; i < count; ++i) {
+            in[i] = randomVector();
+            x[i] = in[i].x();
+            y[i] = in[i].y();
+            z[i] = in[i].z();
+        }
+
+        Batch::transformPoints(m, in, points);
+        Batch::transformDirections(m, in, directions);
+        Batch::transformNormals(m, in, normals);
+        Batch::transformPoints(m, { x, y, z }, Batch::SoA3{ ox, oy, oz });
+
+        const auto& a{ m.data() };
+        Matrix<3> normalMatrix{ Matrix<3>{ a[0], a[1], a[2], a[4], a[5], a[6], a[8], a[9], a[10] }.inverse().transpose() };
+
+        bool exact{ true };
+        for (size_t i{ 0 }; i < count; ++i) {
+            Vector<3> p{ m * Vector<4>(in[i], 1.0f) }, d{ m * Vector<4>(in[i], 0.0f) };
+            exact = exact && std::memcmp(&p, &points[i], sizeof(p)) == 0 && std::memcmp(&d, &directions[i], sizeof(d)) == 0;
+            exact = exact && ox[i] == p.x() && oy[i] == p.y() && oz[i] == p.z();
+
+            Vector<3> n{ (normalMatrix * in[i]).normalized() };
+            exact = exact && std::fabs(n.x() - normals[i].x()) < 1e-6f && std::fabs(n.y() - normals[i].y()) < 1e-6f;
+        }
+        check(exact, "Batch kernels match Matrix * Vector", static_cast<double>(count));
+    }
+
+    std::vector<Vector<3>> shortInput(3), longOutput(4);
+    bool threw{ false };
+    try {
+        Batch::transformPoints(Matrix<4>::identity(), shortInput, longOutput);
+    } catch (Batch::BatchError) {
+        threw = true;
+    }
+    check(threw, "Batch size mismatch throws");
+}
+
+/* OpenGL style perspective looking down -z, 90 degrees wide with near 1 and far 100 */
+constexpr Matrix<4> TestProjection{
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, -101.0f / 99.0f, -200.0f / 99.0f,
+    0.0f, 0.0f, -1.0f, 0.0f
+};
+
+template <typename Test>
+bool masksMatch(const std::vector<std::uint64_t>& mask, size_t count, Test scalar) {
+    for (size_t i{ 0 }; i < count; ++i) {
+        if (testMask(mask, i) != scalar(i))
+            return false;
+    }
+
+    /* bits past the end stay clear */
+    return count % 64 == 0 || (mask[count / 64] >> (count % 64)) == 0;
+}
+
+void testGeometry() {
+    std::printf("geometry\n");
+
+    Worst boxTransform{ "AABB::transformed bounds", 1e-4, true };
+    Worst sphereTransform{ "Sphere::transformed bounds", 1e-4, true };
+    Worst planeTransform{ "Plane::transformed", 1e-4, true };
+    bool mergeHolds{ true };
+
+    for (int i{ 0 }; i < 1000; ++i) {
+        Matrix<4> m{ Affine::trs(randomVector(), randomRotation(), { 2.0f, 0.5f, 3.0f }) };
+
+        AABB box{ AABB::empty().merge(randomVector()).merge(randomVector()) };
+        AABB moved{ box.transformed(m) };
+        for (size_t corner{ 0 }; corner < 8; ++corner) {
+            Vector<3> p{ corner & 1 ? box.max.x() : box.min.x(), corner & 2 ? box.max.y() : box.min.y(), corner & 4 ? box.max.z() : box.min.z() };
+            Vector<3> q{ m * Vector<4>(p, 1.0f) };
+
+            for (size_t k{ 0 }; k < 3; ++k) {
+                boxTransform.add(std::max(0.0f, moved.min[k] - q[k]), 0.0);
+                boxTransform.add(std::max(0.0f, q[k] - moved.max[k]), 0.0);
+            }
+        }
+
+        Sphere sphere{ randomVector(), uniform(0.1f, 5.0f) };
+        Sphere movedSphere{ sphere.transformed(m) };
+        Vector<3> surface{ sphere.center + (randomVector().normalized() * sphere.radius) };
+        Vector<3> offset{ Vector<3>(m * Vector<4>(surface, 1.0f)) - movedSphere.center };
+        sphereTransform.add(std::max(0.0f, offset.magnitude() - movedSphere.radius), 0.0);
+
+        Sphere other{ randomVector(), uniform(0.1f, 5.0f) };
+        Sphere merged{ sphere.merged(other) };
+        float slack{ merged.radius * 1e-5f };
+        mergeHolds = mergeHolds
+            && (merged.center - sphere.center).magnitude() + sphere.radius <= merged.radius + slack
+            && (merged.center - other.center).magnitude() + other.radius <= merged.radius + slack;
+
+        Vector<3> a{ randomVector() }, b{ randomVector() }, c{ randomVector() };
+        Plane plane{ Plane::fromPoints(a, b, c).transformed(m) };
+        for (const Vector<3>& p : { a, b, c }) {
+            planeTransform.add(plane.signedDistance(Vector<3>(m * Vector<4>(p, 1.0f))), 0.0);
+        }
+    }
+
+    check(mergeHolds, "Sphere::merged holds both");
+
+    Frustum frustum{ Frustum::fromMatrix(TestProjection) };
+    check(frustum.contains({ 0.0f, 0.0f, -10.0f }) && frustum.contains({ 9.0f, -9.0f, -10.0f }), "Frustum::contains inside points");
+    check(!frustum.contains({ 0.0f, 0.0f, -0.5f }) && !frustum.contains({ 0.0f, 0.0f, -101.0f }) && !frustum.contains({ 11.0f, 0.0f, -10.0f }),
+          "Frustum::contains outside points");
+    check(std::fabs(frustum.planes[Frustum::Near].signedDistance({ 0.0f, 0.0f, -3.0f }) - 2.0f) < 1e-5f, "Frustum planes are normalized");
+    check(frustum.intersects(AABB{ { 10.5f, -1.0f, -11.0f }, { 12.0f, 1.0f, -9.0f } }) && !frustum.intersects(Sphere{ { 0.0f, 20.0f, -5.0f }, 1.0f }),
+          "Frustum::intersects straddling and outside bounds");
+
+    Ray ray{ { 0.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, -1.0f } };
+    check(ray.intersect(AABB{ { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } }) == 4.0f, "Ray::intersect(AABB)");
+    check(!ray.intersect(AABB{ { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } }, 3.0f), "Ray::intersect(AABB) past maxDistance");
+    check(ray.intersect(Sphere{ { 0.0f, 0.0f, 0.0f }, 2.0f }) == 3.0f && !ray.intersect(Sphere{ { 0.0f, 0.0f, 10.0f }, 2.0f }), "Ray::intersect(Sphere)");
+    check(ray.intersect(Plane::fromPointNormal({ 0.0f, 0.0f, -2.0f }, { 0.0f, 0.0f, 1.0f })) == 7.0f, "Ray::intersect(Plane)");
+
+    for (size_t count : { 0u, 1u, 5u, 31u, 64u, 1000u, 40000u }) {
+        std::vector<float> cx(count), cy(count), cz(count), ex(count), ey(count), ez(count), radius(count);
+        for (size_t i{ 0 }; i < count; ++i) {
+            cx[i] = uniform(-60.0f, 60.0f);
+            cy[i] = uniform(-60.0f, 60.0f);
+            cz[i] = uniform(-120.0f, 10.0f);
+            ex[i] = uniform(0.0f, 5.0f);
+            ey[i] = uniform(0.0f, 5.0f);
+            ez[i] = uniform(0.0f, 5.0f);
+            radius[i] = uniform(0.0f, 5.0f);
+        }
+
+        /* a box face exactly on the ray origin makes 0 * inf, the NaN has to be handled the same in every path */
+        if (count > 2) {
+            cx[2] = 1.0f;
+            ex[2] = 1.0f;
+        }
+
+        AABBSoA boxes{ cx, cy, cz, ex, ey, ez };
+        std::vector<std::uint64_t> mask(maskWords(count), ~0ull);
+
+        frustum.test(boxes, mask);
+        bool boxesMatch{ masksMatch(mask, count, [&](size_t i) { return frustum.intersects(Vector<3>{ cx[i], cy[i], cz[i] }, Vector<3>{ ex[i], ey[i], ez[i] }); }) };
+
+        frustum.test(SphereSoA{ cx, cy, cz, radius }, mask);
+        bool spheresMatch{ masksMatch(mask, count, [&](size_t i) { return frustum.intersects(Sphere{ { cx[i], cy[i], cz[i] }, radius[i] }); }) };
+
+        bool raysMatch{ true };
+        for (const Ray& r : { Ray{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } }, Ray{ randomVector(), randomVector() } }) {
+            r.test(boxes, mask, 80.0f);
+            raysMatch = raysMatch && masksMatch(mask, count, [&](size_t i) {
+                return r.intersect(AABB::fromCenterExtents({ cx[i], cy[i], cz[i] }, { ex[i], ey[i], ez[i] }), 80.0f).has_value();
+            });
+        }
+
+        check(boxesMatch && spheresMatch && raysMatch, "geometry batch tests match the scalar ones", static_cast<double>(count));
+    }
+
+    std::vector<float> three(3), four(4);
+    std::vector<std::uint64_t> mask(1);
+    bool threw{ false };
+    try {
+        frustum.test(SphereSoA{ three, three, three, four }, mask);
+    } catch (GeometryError) {
+        threw = true;
+    }
+    check(threw, "geometry batch size mismatch throws");
+}
+
+void testGpuLayout() {
+    std::printf("gpu layout\n");
+
+    bool columnMajor{ true };
+    for (int i{ 0 }; i < 100; ++i) {
+        Matrix<4> m{ Affine::trs(randomVector(), randomRotation(), randomVector()) };
+        GPU::Mat4 gpu{ m };
+
+        float raw[16];
+        std::memcpy(raw, &gpu, sizeof(raw));
+        for (size_t k{ 0 }; k < 16; ++k) {
+            columnMajor = columnMajor && raw[k] == m.at(k % 4, k / 4);
+        }
+    }
+    check(columnMajor, "GPU::Mat4 is the column-major copy");
+
+    for (size_t count : { 0u, 1u, 5u, 31u }) {
+        std::vector<Vector<3>> in(count);
+        std::vector<Matrix<4>> matrices(count);
+        for (size_t i{ 0 }; i < count; ++i) {
+            in[i] = randomVector();
+            matrices[i] = Affine::translation(in[i]);
+        }
+
+        std::vector<GPU::Vec3> out(count);
+        std::vector<GPU::Mat4> gpuMatrices(count);
+        GPU::convert(in, out);
+        GPU::convert(matrices, gpuMatrices);
+
+        bool same{ true };
+        for (size_t i{ 0 }; i < count; ++i) {
+            same = same && out[i].x == in[i].x() && out[i].y == in[i].y() && out[i].z == in[i].z() && out[i].pad == 0.0f;
+            GPU::Mat4 single{ matrices[i] };
+            same = same && std::memcmp(&gpuMatrices[i], &single, sizeof(single)) == 0;
+        }
+        check(same, "GPU::convert matches the element conversions", static_cast<double>(count));
+    }
+
+    /* a std140 block mirrored field for field */
+    struct Block {
+        GPU::Mat4 model;
+        GPU::Vec3 color;
+        GPU::Vec4 tint;
+        GPU::Vec2 offset;
+    };
+    check(offsetof(Block, color) == 64 && offsetof(Block, tint) == 80 && offsetof(Block, offset) == 96 && sizeof(Block) == 112, "GPU types follow std140 offsets");
+}
+
+void testCamera() {
+    std::printf("camera\n");
+
+    Camera camera{ toRadians(60.0f) };
+    camera.aspect(16.0f / 9.0f);
+    camera.orientation(randomRotation());
+    camera.position(Vector<3>{ 5000.0f, 0.0f, 0.0f });
+
+    /* cached references stay put, only their contents are refreshed */
+    const Matrix<4>& viewProjection{ camera.viewProjectionMatrix() };
+    Matrix<4> before{ viewProjection };
+
+    camera.translate({ 1.0f, 2.0f, 3.0f });
+    check(std::memcmp(&before, &camera.viewProjectionMatrix(), sizeof(before)) == 0, "moving the camera keeps the relative matrices");
+
+    camera.fov(toRadians(70.0f));
+    check(std::memcmp(&before, &camera.viewProjectionMatrix(), sizeof(before)) != 0, "changing the fov rebuilds the projection");
+
+    Matrix<4> identity{ camera.viewProjectionMatrix() * camera.inverseViewProjectionMatrix() };
+    double error{ 0.0 };
+    for (size_t k{ 0 }; k < 16; ++k) {
+        error = std::max(error, std::fabs(static_cast<double>(identity[k]) - (k % 5 == 0 ? 1.0 : 0.0)));
+    }
+    check(error < 1e-4, "inverse view-projection", error);
+
+    Vector<3> ahead{ camera.front() * 10.0f }, behind{ camera.front() * -10.0f };
+    check(camera.frustum().contains(ahead) && !camera.frustum().contains(behind), "Camera::frustum follows the orientation");
+
+    /* another view's frustum in this camera's relative space, as RenderSystem builds them */
+    Vector<3> offset{ 30.0f, -4.0f, 12.0f };
+    Frustum shifted{ Frustum::fromMatrix(camera.viewProjectionMatrix() * Affine::translation(offset), camera.clipDepth()) };
+    bool agrees{ true };
+    for (int i{ 0 }; i < Iterations; ++i) {
+        Vector<3> point{ randomVector(50.0f) };
+        agrees = agrees && shifted.contains(point - offset) == camera.frustum().contains(point);
+    }
+    check(agrees, "a frustum built with an origin offset tests shifted points the same");
+
+    /* reverse-Z: depth = near / distance, nothing is clipped by distance */
+    camera.depthMode(Camera::DepthMode::ReverseInfinite);
+    auto depth{ [&](float distance) {
+        Vector<4> clip{ camera.viewProjectionMatrix() * Vector<4>(camera.front() * distance, 1.0f) };
+        return clip.z() / clip.w();
+    } };
+    check(std::fabs(depth(camera.near()) - 1.0f) < 1e-6f && depth(1e6f) > 0.0f && depth(10.0f) > depth(20.0f), "reverse-Z depth falls from 1 at the near plane");
+    check(camera.frustum().contains(camera.front() * 1e7f) && !camera.frustum().contains(camera.front() * (camera.near() * 0.5f)),
+        "reverse-Z frustum has a near plane and no far plane");
+}
+
+void testMeshOptimizer() {
+    std::printf("mesh optimizer\n");
+
+    /* a grid of quads, the triangles shuffled the way an arbitrary exporter might leave them */
+    constexpr unsigned int Side{ 64 };
+    std::vector<Vector<3>> positions{};
+    for (unsigned int y{ 0 }; y <= Side; ++y) {
+        for (unsigned int x{ 0 }; x <= Side; ++x) {
+            positions.push_back({ static_cast<float>(x), static_cast<float>(y), std::sin(static_cast<float>(x + y) * 0.3f) });
+        }
+    }
+
+    std::vector<std::array<unsigned int, 3>> triangles{};
+    for (unsigned int y{ 0 }; y < Side; ++y) {
+        for (unsigned int x{ 0 }; x < Side; ++x) {
+            unsigned int corner{ (y * (Side + 1)) + x };
+            triangles.push_back({ corner, corner + 1, corner + Side + 2 });
+            triangles.push_back({ corner, corner + Side + 2, corner + Side + 1 });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), sRandom);
+
+    std::vector<unsigned int> indices{};
+    for (const auto& triangle : triangles) {
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+    }
+    std::vector<unsigned int> original{ indices }, remap{};
+
+    MeshOptimizer::Report report{ MeshOptimizer::optimize(indices, positions, remap) };
+    std::printf("  ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+    check(report.before.acmr > 2.0 && report.after.acmr < 0.8, "optimized ACMR", report.after.acmr);
+    check(report.after.atvr >= 1.0 && report.after.atvr < 1.6, "optimized ATVR", report.after.atvr);
+
+    /* the same triangles with the same winding, only reordered and renumbered */
+    std::vector<unsigned int> inverse(remap.size());
+    std::vector<bool> seen(remap.size(), false);
+    bool permutation{ true };
+    for (size_t i{ 0 }; i < remap.size(); ++i) {
+        permutation = permutation && remap[i] < remap.size() && !seen[remap[i]];
+        if (remap[i] < remap.size()) {
+            seen[remap[i]] = true;
+            inverse[remap[i]] = static_cast<unsigned int>(i);
+        }
+    }
+    check(permutation, "vertex remap is a permutation");
+
+    auto canonical{ [](std::vector<unsigned int> list) {
+        std::vector<std::array<unsigned int, 3>> result{};
+        for (size_t t{ 0 }; t < list.size(); t += 3) {
+            std::array<unsigned int, 3> triangle{ list[t], list[t + 1], list[t + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            result.push_back(triangle);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    } };
+    std::vector<unsigned int> restored(indices.size());
+    std::transform(indices.begin(), indices.end(), restored.begin(), [&](unsigned int index) { return inverse[index]; });
+    check(canonical(restored) == canonical(original), "optimization keeps every triangle and its winding");
+
+    /* fetch order: every index is at most one past the largest before it */
+    unsigned int next{ 0 };
+    bool firstUse{ true };
+    for (unsigned int index : indices) {
+        firstUse = firstUse && index <= next;
+        next = std::max(next, index + 1);
+    }
+    check(firstUse, "vertices are numbered in first-use order");
+
+    bool threw{ false };
+    try {
+        MeshOptimizer::analyzeVertexCache(std::vector<unsigned int>{ 0, 1, 5 }, 3);
+    } catch (MeshOptimizer::MeshOptimizerError error) {
+        threw = error == MeshOptimizer::MeshOptimizerError::IndexOutOfRangeError;
+    }
+    check(threw, "out of range indices are rejected");
+}
+
+void testRenderQueue() {
+    std::printf("render queue\n");
+
+    /* random keys over few distinct states, so equal keys exist and stability matters */
+    std::uniform_int_distribution<unsigned int> small{ 0, 3 };
+    std::uniform_real_distribution<float> distance{ -1.0f, 1000.0f };
+    std::vector<RenderQueue::Packet> packets{}, scratch{};
+    for (std::uint32_t i{ 0 }; i < 10000; ++i) {
+        float depth{ small(sRandom) == 0 ? 5.0f : distance(sRandom) };
+        packets.push_back({ RenderQueue::makeKey(small(sRandom), 1 + small(sRandom), 1 + small(sRandom), depth), i });
+    }
+
+    std::vector<RenderQueue::Packet> expected{ packets };
+    std::stable_sort(expected.begin(), expected.end(), [](const RenderQueue::Packet& a, const RenderQueue::Packet& b) { return a.key < b.key; });
+    RenderQueue::sort(packets, scratch);
+
+    bool same{ packets.size() == expected.size() };
+    for (size_t i{ 0 }; same && i < packets.size(); ++i) {
+        same = packets[i].key == expected[i].key && packets[i].draw == expected[i].draw;
+    }
+    check(same, "radix sort matches a stable sort", 0.0);
+
+    /* keys sharing their upper bytes take the skipped-pass path */
+    std::vector<RenderQueue::Packet> shared{ { RenderQueue::makeKey(1, 2, 3, 9.0f), 0 }, { RenderQueue::makeKey(1, 2, 3, 2.0f), 1 }, { RenderQueue::makeKey(1, 2, 3, 9.0f), 2 } };
+    RenderQueue::sort(shared, scratch);
+    check(shared[0].draw == 1 && shared[1].draw == 0 && shared[2].draw == 2, "radix sort with shared bytes", 0.0);
+
+    check(RenderQueue::makeKey(0, 9, 9, 1e6f) < RenderQueue::makeKey(1, 1, 1, 0.0f), "pass orders before shader", 0.0);
+    check(RenderQueue::makeKey(0, 1, 9, 1e6f) < RenderQueue::makeKey(0, 2, 1, 0.0f), "shader orders before mesh", 0.0);
+    check(RenderQueue::makeKey(0, 1, 1, 1e6f) < RenderQueue::makeKey(0, 1, 2, 0.0f), "mesh orders before depth", 0.0);
+    check(RenderQueue::makeKey(0, 1, 1, 0.5f) < RenderQueue::makeKey(0, 1, 1, 2.0f), "near before far", 0.0);
+    check(RenderQueue::makeKey(0, 1, 1, -3.0f) == RenderQueue::makeKey(0, 1, 1, 0.0f), "behind the camera clamps to zero", 0.0);
+    check(RenderQueue::stateOf(RenderQueue::makeKey(2, 3, 4, 1.0f)) == RenderQueue::stateOf(RenderQueue::makeKey(2, 3, 4, 7.0f)), "state ignores depth", 0.0);
+}
+
+void testStats() {
+    std::printf("frame stats\n");
+
+    /* below Window: 1..100 ms in random order, nearest rank picks the k-th smallest */
+    FrameStats small{};
+    std::vector<int> order(100);
+    for (size_t i{ 0 }; i < order.size(); ++i) {
+        order[i] = static_cast<int>(i) + 1;
+    }
+    std::shuffle(order.begin(), order.end(), sRandom);
+    for (int ms : order) {
+        small.record(FrameStats::Frame, ms * 0.001);
+    }
+
+    FrameStats::Summary s{ small.summary(FrameStats::Frame) };
+    check(s.samples == 100 && s.p50 == 50 * 0.001 && s.p95 == 95 * 0.001 && s.p99 == 99 * 0.001 && s.max == 100 * 0.001,
+          "FrameStats percentiles below the window", s.p99);
+    check(std::fabs(s.mean - 0.0505) < 1e-12 && s.hitches == 67, "FrameStats mean and hitches", static_cast<double>(s.hitches));
+
+    /* above Window: the first samples must have wrapped out of the rolling window but stay in the session totals */
+    FrameStats large{};
+    for (int i{ 0 }; i < 500; ++i) {
+        large.record(FrameStats::Frame, 5.0);
+    }
+    order.resize(FrameStats::Window);
+    for (size_t i{ 0 }; i < order.size(); ++i) {
+        order[i] = static_cast<int>(i) + 1;
+    }
+    std::shuffle(order.begin(), order.end(), sRandom);
+    for (int tenths : order) {
+        large.record(FrameStats::Frame, tenths * 0.0001);
+    }
+
+    s = large.summary(FrameStats::Frame);
+    check(s.samples == FrameStats::Window && s.p50 == 512 * 0.0001 && s.p95 == 973 * 0.0001 && s.p99 == 1014 * 0.0001 && s.max == 1024 * 0.0001,
+          "FrameStats percentiles after wraparound", s.max);
+    check(large.totalSamples(FrameStats::Frame) == 1524 && large.totalHitches(FrameStats::Frame) == 1191 && s.hitches == 691,
+          "FrameStats hitch counts", static_cast<double>(large.totalHitches(FrameStats::Frame)));
+
+    /* a new threshold reclassifies the window at once but only future samples in the session totals; the new sample evicts order[0] */
+    large.hitchThreshold(0.05005);
+    large.record(FrameStats::Frame, 0.04);
+    s = large.summary(FrameStats::Frame);
+    size_t expected{ order[0] > 500 ? 523u : 524u };
+    check(large.hitchThreshold() == 0.05005 && large.totalHitches(FrameStats::Frame) == 1191 && s.hitches == expected,
+          "FrameStats hitches after a threshold change", static_cast<double>(s.hitches));
+
+    /* bucket i holds [i, i + 1) * width, the last bucket everything above */
+    FrameStats buckets{};
+    for (double seconds : { 0.0, 0.00025, 0.00075, 0.001, 0.03124, 0.03175, 5.0 }) {
+        buckets.record(FrameStats::Draw, seconds);
+    }
+    std::array<size_t, FrameStats::HistogramBuckets> histogram{ buckets.histogram(FrameStats::Draw) };
+    check(histogram[0] == 2 && histogram[1] == 1 && histogram[2] == 1 && histogram[62] == 1 && histogram[FrameStats::HistogramBuckets - 1] == 2,
+          "FrameStats histogram edges and overflow", static_cast<double>(histogram[FrameStats::HistogramBuckets - 1]));
+    check(buckets.histogram("missing")[0] == 0 && buckets.summary("missing").samples == 0, "FrameStats unknown series");
+
+    /* the extension picks the format */
+    auto firstLines{ [](const std::filesystem::path& path) {
+        std::ifstream in{ path };
+        std::string header{}, row{};
+        std::getline(in, header);
+        std::getline(in, row);
+        return std::array<std::string, 2>{ header, row };
+    } };
+
+    std::filesystem::path directory{ std::filesystem::temp_directory_path() };
+    std::filesystem::path csvPath{ directory / "bmath_stats.csv" }, jsonPath{ directory / "bmath_stats.json" };
+    bool written{ small.write(csvPath.string()) && small.write(jsonPath.string()) };
+
+    std::array<std::string, 2> csv{ firstLines(csvPath) }, json{ firstLines(jsonPath) };
+    check(written && csv[0].starts_with("series,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,hitches,") && csv[1].starts_with("frame,100,50.5,50,95,99,100,67,"),
+          "FrameStats::write CSV");
+    check(written && json[0].starts_with("{\"hitchThresholdMs\":") && json[0].find("{\"name\":\"frame\",\"samples\":100,") != std::string::npos
+          && json[0].ends_with("]}") && json[1].empty(), "FrameStats::write JSON");
+
+    std::filesystem::remove(csvPath);
+    std::filesystem::remove(jsonPath);
+
+    /* nested scopes: only the leaves read counters and the parent reports their sum (all zero where perf is unavailable) */
+    FrameStats nested{};
+    PerfCounters::enable(true);
+    {
+        StatsScope parent{ nested, FrameStats::Update };
+        for (const char* name : { "first", "second" }) {
+            StatsScope child{ nested, name };
+            volatile double sink{ 0.0 };
+            for (int i{ 0 }; i < 10000; ++i) {
+                sink = sink + std::sqrt(static_cast<double>(i));
+            }
+        }
+    }
+    PerfCounters::enable(false);
+
+    std::array<double, PerfCounters::CounterCount> parentCounts{ nested.counters(FrameStats::Update) };
+    std::array<double, PerfCounters::CounterCount> first{ nested.counters("first") }, second{ nested.counters("second") };
+    bool summed{ true };
+    for (size_t i{ 0 }; i < PerfCounters::CounterCount; ++i) {
+        summed = summed && parentCounts[i] == first[i] + second[i];
+    }
+    check(summed && nested.totalSamples(FrameStats::Update) == 1, "StatsScope reports the sum of nested counters");
+    check(nested.summary(FrameStats::Update).max >= nested.summary("first").max, "StatsScope times nested scopes",
+          nested.summary(FrameStats::Update).max);
+}
+
+void testFast() {
+    std::printf("fast math\n");
+#if defined(BEG_SIMD_SSE)
+    Worst rsqrt{ "Fast::rsqrt", 5.0 };
+#else
+    Worst rsqrt{ "Fast::rsqrt", 3.0 };
+#endif
+    Worst sine{ "Fast::sin", 2.0 }, cosine{ "Fast::cos", 2.0 };
+    Worst sineRoots{ "Fast::sin near roots", std::ldexp(1.0, -32), true }, cosineRoots{ "Fast::cos near roots", std::ldexp(1.0, -32), true };
+    Worst atan{ "Fast::atan2 (radians)", 2e-6, true };
+
+    /* the ULP bound holds where the result is at least 2^-12, the absolute one below that */
+    auto trig{ [](Worst& relative, Worst& roots, float value, double ref) {
+        if (std::fabs(ref) >= std::ldexp(1.0, -12))
+            relative.add(value, ref);
+        else
+            roots.add(value, ref);
+    } };
+
+    bool vectorMatches{ true };
+
+    for (int i{ 0 }; i < Iterations * 10; ++i) {
+        float x{ std::ldexp(uniform(1.0f, 2.0f), static_cast<int>(uniform(-100.0f, 100.0f))) };
+        rsqrt.add(Fast::rsqrt(x), 1.0 / std::sqrt(static_cast<double>(x)));
+
+        float angle{ i % 2 == 0 ? uniform(-10.0f, 10.0f) : uniform(-8192.0f, 8192.0f) };
+        float s, c;
+        Fast::sincos(angle, s, c);
+        trig(sine, sineRoots, s, std::sin(static_cast<double>(angle)));
+        trig(cosine, cosineRoots, c, std::cos(static_cast<double>(angle)));
+
+        if (i % 4 == 0) {
+            float lanes[4]{ angle, -angle, uniform(-1.0f, 1.0f), i % 8 == 0 ? 1e5f : 0.0f }, sines[4], cosines[4];
+            SIMD::Float4 s4, c4;
+            Fast::sincos4(SIMD::load(lanes), s4, c4);
+            SIMD::store(sines, s4);
+            SIMD::store(cosines, c4);
+
+            for (int k{ 0 }; k < 4; ++k) {
+                Fast::sincos(lanes[k], s, c);
+                vectorMatches = vectorMatches && sines[k] == s && cosines[k] == c;
+            }
+        }
+
+        float ay{ uniform(-100.0f, 100.0f) }, ax{ uniform(-100.0f, 100.0f) };
+        atan.add(Fast::atan2(ay, ax), std::atan2(static_cast<double>(ay), static_cast<double>(ax)));
+    }
+
+    check(vectorMatches, "Fast::sincos4 matches Fast::sincos");
+}
+
+/* a few compile-time evaluations, failing here fails the build */
+constexpr Matrix<4> ConstantTransform{ Affine::translation(1.0f, 2.0f, 3.0f) * Affine::scale(2.0f) };
+static_assert(ConstantTransform.inverse().at(0, 3) == -0.5f);
+static_assert((ConstantTransform * Vector<4>(1.0f, 1.0f, 1.0f, 1.0f)).y() == 4.0f);
+static_assert(toRadians(180.0f) == Pi);
+static_assert(TRS{}.transformPoint({ 1.0f, 2.0f, 3.0f }).z() == 3.0f);
+static_assert(std::is_convertible_v<Vector<3>, Vector<3, double>> && !std::is_convertible_v<Vector<3, double>, Vector<3>>);
+static_assert(AABB::empty().merge({ 1.0f, 2.0f, 3.0f }).merge({ -1.0f, 0.0f, 5.0f }).center().z() == 4.0f);
+
+}
+
+int main() {
+#if defined(__AVX2__) && defined(__GNUC__)
+    /* meson's skip code, for the AVX2 build of these tests on a machine that cannot run it */
+    if (!__builtin_cpu_supports("avx2")) {
+        std::printf("bmath tests built for AVX2, which this CPU lacks; skipped\n");
+        return 77;
+    }
+#endif
+
+#if defined(BEG_SIMD_AVX)
+    std::printf("bmath tests, SIMD on, 8 wide\n");
+#else
+    std::printf("bmath tests, SIMD %s\n", SIMD::Enabled ? "on" : "off");
+#endif
+
+    testVectors();
+    testMatrices();
+    testQuaternions();
+    testTransforms();
+    testDoublePrecision();
+    testBatch();
+    testGeometry();
+    testGpuLayout();
+    testCamera();
+    testMeshOptimizer();
+    testRenderQueue();
+    testStats();
+    testFast();
+
+    std::printf("%d/%d checks passed\n", sChecks - sFailures, sChecks);
+    return sFailures == 0 ? 0 : 1;
+}